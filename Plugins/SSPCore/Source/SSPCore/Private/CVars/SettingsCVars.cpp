@@ -0,0 +1,123 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CVars/SettingsCVars.h"
+
+static const TCHAR* const GSettingsCVarNames[] =
+{
+	TEXT("r.ToneMapperGamma"),
+	TEXT("r.DynamicRes.MinScreenPercentage"),
+	TEXT("r.DynamicRes.MaxScreenPercentage"),
+	TEXT("r.DynamicRes.FrameTimeBudget"),
+	TEXT("r.OneFrameThreadLag"),
+	TEXT("r.GTSyncType"),
+	TEXT("rhi.SyncSlackMS"),
+	TEXT("D3D12.MaximumFrameLatency"),
+	TEXT("r.Streaming.PoolSize"),
+	TEXT("r.Streaming.PoolSizeForMeshes"),
+};
+static_assert(UE_ARRAY_COUNT(GSettingsCVarNames) == static_cast<int32>(ESettingsCVar::Num), "One name per ESettingsCVar");
+
+static IConsoleVariable* GSettingsCVarHandles[static_cast<int32>(ESettingsCVar::Num)] = {};
+
+IConsoleVariable* SettingsCVars::Get(ESettingsCVar CVar)
+{
+	check(IsInGameThread());
+	const int32 Index = static_cast<int32>(CVar);
+	IConsoleVariable*& Handle = GSettingsCVarHandles[Index];
+	if (!Handle)
+	{
+		// Renderer CVars register when their module loads; keep trying until then
+		Handle = IConsoleManager::Get().FindConsoleVariable(GSettingsCVarNames[Index]);
+	}
+	return Handle;
+}
+
+const TCHAR* SettingsCVars::GetName(ESettingsCVar CVar)
+{
+	return GSettingsCVarNames[static_cast<int32>(CVar)];
+}
+
+float SettingsCVars::GetFloat(ESettingsCVar CVar, float Fallback)
+{
+	const IConsoleVariable* Handle = Get(CVar);
+	return Handle ? Handle->GetFloat() : Fallback;
+}
+
+void FSettingsCVarTransaction::Stage(ESettingsCVar CVar, float Value)
+{
+	check(!bCommitted);
+	for (FEntry& Entry : Entries)
+	{
+		if (Entry.CVar == CVar)
+		{
+			Entry.Value = Value;
+			return;
+		}
+	}
+	Entries.Add({ CVar, Value, 0.f, false });
+}
+
+void FSettingsCVarTransaction::Commit(EConsoleVariableFlags SetBy)
+{
+	check(!bCommitted);
+	for (FEntry& Entry : Entries)
+	{
+		if (IConsoleVariable* Handle = SettingsCVars::Get(Entry.CVar))
+		{
+			Entry.Previous = Handle->GetFloat();
+			// Set drops lower-priority writes without a word, so say which source wins
+			const EConsoleVariableFlags HeldBy = static_cast<EConsoleVariableFlags>(Handle->GetFlags() & ECVF_SetByMask);
+			if (static_cast<uint32>(HeldBy) > static_cast<uint32>(SetBy & ECVF_SetByMask))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("SettingsCVars: %s is set by %s and keeps %g instead of %g"),
+					SettingsCVars::GetName(Entry.CVar), GetConsoleVariableSetByName(HeldBy), Entry.Previous, Entry.Value);
+			}
+			Handle->Set(Entry.Value, SetBy);
+			// Int CVars truncate, and everything staged for them is whole already
+			Entry.bApplied = FMath::IsNearlyEqual(Handle->GetFloat(), Entry.Value, 1e-3f);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SettingsCVars: %s is not registered, skipped"), SettingsCVars::GetName(Entry.CVar));
+			Entry.Previous = Entry.Value;
+			Entry.bApplied = false;
+		}
+	}
+	CommittedSetBy = SetBy;
+	bCommitted = true;
+}
+
+bool FSettingsCVarTransaction::WasApplied(ESettingsCVar CVar) const
+{
+	for (const FEntry& Entry : Entries)
+	{
+		if (Entry.CVar == CVar)
+		{
+			return Entry.bApplied;
+		}
+	}
+	return true;
+}
+
+void FSettingsCVarTransaction::Rollback()
+{
+	if (!bCommitted)
+	{
+		return;
+	}
+	for (int32 i = Entries.Num() - 1; i >= 0; --i)
+	{
+		if (IConsoleVariable* Handle = SettingsCVars::Get(Entries[i].CVar))
+		{
+			Handle->Set(Entries[i].Previous, CommittedSetBy);
+		}
+	}
+	Reset();
+}
+
+void FSettingsCVarTransaction::Reset()
+{
+	Entries.Reset();
+	bCommitted = false;
+}
@@ -2,3 +2,26 @@
 
 
 #include "Data/PendingSettings.h"
+
+#include "Data/SettingsSchema.h"
+
+const FName SettingsAudioChannels::Master = TEXT("Master");
+const FName SettingsAudioChannels::SFX = TEXT("SFX");
+const FName SettingsAudioChannels::Dialogue = TEXT("Dialogue");
+
+bool FPendingSettings::IsValid() const
+{
+	if (ChannelVolumes.Num() > 0)
+	{
+		return true;
+	}
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	for (int32 i = 0; i < Schema.NumBuiltIn(); ++i)
+	{
+		if (Schema.ReadPending(i, *this) >= 0.0f)
+		{
+			return true;
+		}
+	}
+	return false;
+}
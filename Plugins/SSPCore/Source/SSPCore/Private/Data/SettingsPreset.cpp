@@ -0,0 +1,11 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Data/SettingsPreset.h"
+
+FUserSettingsData USettingsPreset::GetResolvedSettings() const
+{
+	FUserSettingsData Resolved = Settings.MergedWith(FPendingSettings());
+	Resolved.ClampPerformanceFields();
+	return Resolved;
+}
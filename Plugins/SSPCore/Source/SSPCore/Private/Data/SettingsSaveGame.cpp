@@ -4,17 +4,132 @@
 #include "Data/SettingsSaveGame.h"
 
 #include "Data/PendingSettings.h"
+#include "Data/SettingsSchema.h"
 #include "Subsystems/SettingsSubsystem.h"
 
+static std::atomic<uint32> GNumSettingsSavesCreated{ 0 };
+
+USettingsSaveGame::USettingsSaveGame()
+{
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		GNumSettingsSavesCreated.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+uint32 USettingsSaveGame::GetNumCreated()
+{
+	return GNumSettingsSavesCreated.load(std::memory_order_relaxed);
+}
+
 void USettingsSaveGame::SaveData(const FPendingSettings& PendingSettingsData)
 {
-	
-	Data.GraphicsQuality = PendingSettingsData.GraphicsQuality;
-	Data.Brightness = PendingSettingsData.Brightness;
-	Data.MasterVolume = PendingSettingsData.MasterVolume;
-	Data.SFXVolume = PendingSettingsData.SFXVolume;
-	Data.DialogueVolume = PendingSettingsData.DialogueVolume;
-	Data.WindowMode = PendingSettingsData.WindowMode;
+	Data = Data.MergedWith(PendingSettingsData);
+}
+
+FPendingSettings FUserSettingsData::GetAsPendingSettings() const
+{
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	FPendingSettings PendingData;
+	for (int32 i = 0; i < Schema.NumBuiltIn(); ++i)
+	{
+		Schema.WritePending(i, PendingData, Schema.ReadUser(i, *this));
+	}
+	PendingData.ChannelVolumes = ChannelVolumes;
+	return PendingData;
+}
+
+FUserSettingsData FUserSettingsData::MergedWith(const FPendingSettings& Pending) const
+{
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	FUserSettingsData Out = *this;
+	for (int32 i = 0; i < Schema.NumBuiltIn(); ++i)
+	{
+		const float Value = Schema.ReadPending(i, Pending);
+		if (Value >= 0.0f)
+		{
+			Schema.WriteUser(i, Out, Value);
+		}
+	}
+
+	// Groups not queued themselves follow a queued overall level; saves from before
+	// per-group settings (-1) follow the saved one
+	for (int32 i = 0; i < ScalabilityGroup::Num; ++i)
+	{
+		const EScalabilityGroup Group = static_cast<EScalabilityGroup>(i);
+		int32& Level = ScalabilityGroup::Level(Out, Group);
+		if (ScalabilityGroup::Level(Pending, Group) < 0 && (Pending.GraphicsQuality >= 0 || Level < 0))
+		{
+			Level = FMath::Max(Out.GraphicsQuality, 0);
+		}
+	}
+	Out.GraphicsQuality = Out.GetUniformScalabilityLevel();
+
+	for (const TPair<FName, float>& Channel : Pending.ChannelVolumes)
+	{
+		Out.ChannelVolumes.Add(Channel.Key, Channel.Value);
+	}
+	return Out;
+}
+
+float FUserSettingsData::GetMergedValue(int32 Index, const FPendingSettings& Pending) const
+{
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	const ESettingsField Field = Schema[Index].Field;
+	if (Field == ESettingsField::GraphicsQuality)
+	{
+		// Recomputed from the merged groups, -1 when they differ
+		const int32 First = GetMergedScalabilityLevel(static_cast<EScalabilityGroup>(0), Pending);
+		for (int32 i = 1; i < ScalabilityGroup::Num; ++i)
+		{
+			if (GetMergedScalabilityLevel(static_cast<EScalabilityGroup>(i), Pending) != First)
+			{
+				return -1.0f;
+			}
+		}
+		return static_cast<float>(First);
+	}
+	for (int32 i = 0; i < ScalabilityGroup::Num; ++i)
+	{
+		const EScalabilityGroup Group = static_cast<EScalabilityGroup>(i);
+		if (Field == ScalabilityGroup::Field(Group))
+		{
+			return static_cast<float>(GetMergedScalabilityLevel(Group, Pending));
+		}
+	}
+	const float Queued = Schema.ReadPending(Index, Pending);
+	return Queued >= 0.0f ? Queued : Schema.ReadUser(Index, *this);
+}
+
+int32 FUserSettingsData::GetMergedScalabilityLevel(EScalabilityGroup Group, const FPendingSettings& Pending) const
+{
+	const int32 Queued = ScalabilityGroup::Level(Pending, Group);
+	if (Queued >= 0)
+	{
+		return Queued;
+	}
+	// Same rule as MergedWith: follows a queued overall level, or the saved one for a legacy -1
+	const int32 Level = ScalabilityGroup::Level(*this, Group);
+	if (Pending.GraphicsQuality >= 0 || Level < 0)
+	{
+		return FMath::Max(Pending.GraphicsQuality >= 0 ? Pending.GraphicsQuality : GraphicsQuality, 0);
+	}
+	return Level;
+}
+
+ESettingsField FUserSettingsData::Diff(const FUserSettingsData& Other) const
+{
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	ESettingsField Out = ESettingsField::None;
+	for (int32 i = 0; i < Schema.NumBuiltIn(); ++i)
+	{
+		if (!FMath::IsNearlyEqual(Schema.ReadUser(i, *this), Schema.ReadUser(i, Other)))
+		{
+			Out |= Schema[i].Field;
+		}
+	}
+	if (!ChannelVolumes.OrderIndependentCompareEqual(Other.ChannelVolumes)) Out |= ESettingsField::ChannelVolumes;
+	return Out;
 }
 
 
@@ -0,0 +1,228 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Data/SettingsSchema.h"
+
+#include "Data/PendingSettings.h"
+#include "Data/SettingsSaveGame.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	struct FBuiltInSetting
+	{
+		// FPendingSettings field, also the key
+		const TCHAR* Key;
+		// FUserSettingsData field when it differs (bools are int32 with -1 in FPendingSettings)
+		const TCHAR* UserField;
+		float Min;
+		float Max;
+		ESettingsField Field;
+	};
+
+	// Every scalar setting. Types and defaults come from the struct fields.
+	const FBuiltInSetting GBuiltInSettings[] =
+	{
+		{ TEXT("GraphicsQuality"),				nullptr,	0.f,	4.f,	ESettingsField::GraphicsQuality },
+		{ TEXT("ViewDistanceQuality"),			nullptr,	0.f,	4.f,	ESettingsField::ViewDistanceQuality },
+		{ TEXT("AntiAliasingQuality"),			nullptr,	0.f,	4.f,	ESettingsField::AntiAliasingQuality },
+		{ TEXT("ShadowQuality"),				nullptr,	0.f,	4.f,	ESettingsField::ShadowQuality },
+		{ TEXT("GlobalIlluminationQuality"),	nullptr,	0.f,	4.f,	ESettingsField::GlobalIlluminationQuality },
+		{ TEXT("ReflectionQuality"),			nullptr,	0.f,	4.f,	ESettingsField::ReflectionQuality },
+		{ TEXT("PostProcessQuality"),			nullptr,	0.f,	4.f,	ESettingsField::PostProcessQuality },
+		{ TEXT("TextureQuality"),				nullptr,	0.f,	4.f,	ESettingsField::TextureQuality },
+		{ TEXT("EffectsQuality"),				nullptr,	0.f,	4.f,	ESettingsField::EffectsQuality },
+		{ TEXT("FoliageQuality"),				nullptr,	0.f,	4.f,	ESettingsField::FoliageQuality },
+		{ TEXT("ShadingQuality"),				nullptr,	0.f,	4.f,	ESettingsField::ShadingQuality },
+		{ TEXT("Brightness"),					nullptr,	0.5f,	3.f,	ESettingsField::Brightness },
+		{ TEXT("MasterVolume"),					nullptr,	0.f,	1.f,	ESettingsField::MasterVolume },
+		{ TEXT("SFXVolume"),					nullptr,	0.f,	1.f,	ESettingsField::SFXVolume },
+		{ TEXT("DialogueVolume"),				nullptr,	0.f,	1.f,	ESettingsField::DialogueVolume },
+		{ TEXT("WindowMode"),					nullptr,	0.f,	2.f,	ESettingsField::WindowMode },
+		{ TEXT("ResolutionIndex"),				nullptr,	0.f,	1024.f,	ESettingsField::ResolutionIndex },
+		{ TEXT("RefreshRate"),					nullptr,	0.f,	1000.f,	ESettingsField::RefreshRate },
+		{ TEXT("FrameRateLimit"),				nullptr,	0.f,	1000.f,	ESettingsField::FrameRateLimit },
+		{ TEXT("VSync"),						TEXT("bVSync"),	0.f,	1.f,	ESettingsField::VSync },
+		{ TEXT("ScreenPercentage"),				nullptr,	10.f,	200.f,	ESettingsField::ScreenPercentage },
+		{ TEXT("DynamicResolution"),			TEXT("bDynamicResolution"),	0.f,	1.f,	ESettingsField::DynamicResolution },
+		{ TEXT("DynResMinScreenPercentage"),	nullptr,	10.f,	100.f,	ESettingsField::DynResMinScreenPercentage },
+		{ TEXT("DynResMaxScreenPercentage"),	nullptr,	10.f,	200.f,	ESettingsField::DynResMaxScreenPercentage },
+		{ TEXT("DynResFrameTimeBudgetMs"),		nullptr,	1.f,	1000.f,	ESettingsField::DynResFrameTimeBudgetMs },
+		{ TEXT("LatencyMode"),					nullptr,	0.f,	2.f,	ESettingsField::LatencyMode },
+		{ TEXT("TexturePoolSizeMB"),			nullptr,	0.f,	16384.f,	ESettingsField::TexturePoolSize },
+		{ TEXT("MeshPoolSizeMB"),				nullptr,	0.f,	8192.f,	ESettingsField::MeshPoolSize },
+	};
+
+	float ReadProperty(const FProperty* Property, const void* Container)
+	{
+		const void* Value = Property->ContainerPtrToValuePtr<void>(Container);
+		if (const FBoolProperty* Bool = CastField<FBoolProperty>(Property))
+		{
+			return Bool->GetPropertyValue(Value) ? 1.0f : 0.0f;
+		}
+		const FNumericProperty* Numeric = CastFieldChecked<FNumericProperty>(Property);
+		return Numeric->IsFloatingPoint()
+			? static_cast<float>(Numeric->GetFloatingPointPropertyValue(Value))
+			: static_cast<float>(Numeric->GetSignedIntPropertyValue(Value));
+	}
+
+	void WriteProperty(const FProperty* Property, void* Container, float In)
+	{
+		void* Value = Property->ContainerPtrToValuePtr<void>(Container);
+		if (const FBoolProperty* Bool = CastField<FBoolProperty>(Property))
+		{
+			Bool->SetPropertyValue(Value, In != 0.0f);
+			return;
+		}
+		const FNumericProperty* Numeric = CastFieldChecked<FNumericProperty>(Property);
+		if (Numeric->IsFloatingPoint())
+		{
+			Numeric->SetFloatingPointPropertyValue(Value, static_cast<double>(In));
+		}
+		else
+		{
+			Numeric->SetIntPropertyValue(Value, static_cast<int64>(FMath::RoundToInt(In)));
+		}
+	}
+}
+
+float FSettingDescriptor::Sanitize(float Value) const
+{
+	Value = FMath::Clamp(Value, Min, Max);
+	return Type == ESettingValueType::Float ? Value : FMath::RoundToFloat(Value);
+}
+
+FSettingsSchema& FSettingsSchema::Get()
+{
+	static FSettingsSchema Schema;
+	return Schema;
+}
+
+FSettingsSchema::FSettingsSchema()
+{
+	const UScriptStruct* UserStruct = FUserSettingsData::StaticStruct();
+	const UScriptStruct* PendingStruct = FPendingSettings::StaticStruct();
+	const FUserSettingsData Defaults;
+
+	for (const FBuiltInSetting& Setting : GBuiltInSettings)
+	{
+		FSettingDescriptor Descriptor;
+		Descriptor.Key = Setting.Key;
+		Descriptor.UserProperty = UserStruct->FindPropertyByName(Setting.UserField ? FName(Setting.UserField) : Descriptor.Key);
+		Descriptor.PendingProperty = PendingStruct->FindPropertyByName(Descriptor.Key);
+		checkf(Descriptor.UserProperty && Descriptor.PendingProperty, TEXT("Settings schema: no field for %s"), Setting.Key);
+
+		Descriptor.Type = Descriptor.UserProperty->IsA<FBoolProperty>() ? ESettingValueType::Bool
+			: CastFieldChecked<FNumericProperty>(Descriptor.UserProperty)->IsFloatingPoint() ? ESettingValueType::Float
+			: ESettingValueType::Int;
+		Descriptor.Min = Setting.Min;
+		Descriptor.Max = Setting.Max;
+		Descriptor.Default = ReadProperty(Descriptor.UserProperty, &Defaults);
+		Descriptor.Field = Setting.Field;
+		Register(MoveTemp(Descriptor));
+	}
+	BuiltInCount = Descriptors.Num();
+}
+
+int32 FSettingsSchema::Register(FSettingDescriptor Descriptor)
+{
+	if (const int32* Existing = KeyToIndex.Find(Descriptor.Key))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Settings schema: %s is already registered"), *Descriptor.Key.ToString());
+		return *Existing;
+	}
+	const int32 Index = Descriptors.Add(MoveTemp(Descriptor));
+	KeyToIndex.Add(Descriptors[Index].Key, Index);
+	return Index;
+}
+
+float FSettingsSchema::ReadUser(int32 Index, const FUserSettingsData& Data) const
+{
+	const FSettingDescriptor& Descriptor = Descriptors[Index];
+	return Descriptor.UserProperty ? ReadProperty(Descriptor.UserProperty, &Data) : Descriptor.Default;
+}
+
+void FSettingsSchema::WriteUser(int32 Index, FUserSettingsData& Data, float Value) const
+{
+	if (const FProperty* Property = Descriptors[Index].UserProperty)
+	{
+		WriteProperty(Property, &Data, Value);
+	}
+}
+
+float FSettingsSchema::ReadPending(int32 Index, const FPendingSettings& Pending) const
+{
+	const FProperty* Property = Descriptors[Index].PendingProperty;
+	return Property ? ReadProperty(Property, &Pending) : -1.0f;
+}
+
+void FSettingsSchema::WritePending(int32 Index, FPendingSettings& Pending, float Value) const
+{
+	if (const FProperty* Property = Descriptors[Index].PendingProperty)
+	{
+		WriteProperty(Property, &Pending, Value);
+	}
+}
+
+void FSettingsValues::Reset()
+{
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	Values.SetNumUninitialized(Schema.Num());
+	for (int32 i = 0; i < Values.Num(); ++i)
+	{
+		Values[i] = Schema[i].Default;
+	}
+	Dirty.Init(false, Values.Num());
+}
+
+bool FSettingsValues::Set(int32 Index, float Value)
+{
+	EnsureSize();
+	const float Sanitized = FSettingsSchema::Get()[Index].Sanitize(Value);
+	if (Values[Index] == Sanitized)
+	{
+		return false;
+	}
+	Values[Index] = Sanitized;
+	Dirty[Index] = true;
+	return true;
+}
+
+float FSettingsValues::Get(int32 Index) const
+{
+	return Values.IsValidIndex(Index) ? Values[Index] : FSettingsSchema::Get()[Index].Default;
+}
+
+void FSettingsValues::SaveTo(TMap<FName, float>& Out) const
+{
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	for (int32 i = Schema.NumBuiltIn(); i < Values.Num(); ++i)
+	{
+		Out.Add(Schema[i].Key, Values[i]);
+	}
+}
+
+void FSettingsValues::LoadFrom(const TMap<FName, float>& In)
+{
+	Reset();
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	for (const TPair<FName, float>& Saved : In)
+	{
+		const int32 Index = Schema.IndexOf(Saved.Key);
+		if (Index >= Schema.NumBuiltIn())
+		{
+			Values[Index] = Schema[Index].Sanitize(Saved.Value);
+		}
+	}
+}
+
+void FSettingsValues::EnsureSize()
+{
+	// Settings registered after Reset start at their defaults
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	for (int32 i = Values.Num(); i < Schema.Num(); ++i)
+	{
+		Values.Add(Schema[i].Default);
+		Dirty.Add(false);
+	}
+}
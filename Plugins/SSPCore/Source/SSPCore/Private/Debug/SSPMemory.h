@@ -0,0 +1,9 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HAL/LowLevelMemTracker.h"
+
+// LLM tags for SSPCore, with per-subsystem children under the plugin tag
+LLM_DECLARE_TAG(SSPCore);
+LLM_DECLARE_TAG(SSPCore_SettingsSubsystem);
@@ -0,0 +1,47 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Debug/SSPMemory.h"
+
+#include "Data/SettingsSaveGame.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Subsystems/SettingsSubsystem.h"
+
+LLM_DEFINE_TAG(SSPCore);
+LLM_DEFINE_TAG(SSPCore_SettingsSubsystem, NAME_None, TEXT("SSPCore"));
+
+namespace SSPMemoryReport
+{
+	// One "key=value" line per section so CI can grep and diff the output
+	void Dump(UWorld* World, FOutputDevice& Ar)
+	{
+		// Lifetime average, not a recent rate
+		const double Minutes = FMath::Max((FPlatformTime::Seconds() - GStartTime) / 60.0, 1.0 / 60.0);
+
+		const uint32 SavesCreated = USettingsSaveGame::GetNumCreated();
+		Ar.Logf(TEXT("SSPMemReport SettingsSaveGame created=%u per_minute_since_start=%.2f"), SavesCreated, SavesCreated / Minutes);
+
+		UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+		if (!GI)
+		{
+			Ar.Logf(TEXT("SSPMemReport no game instance, subsystem sections skipped"));
+			return;
+		}
+
+		if (const USettingsSubsystem* Sub = GI->GetSubsystem<USettingsSubsystem>())
+		{
+			Ar.Logf(TEXT("SSPMemReport SettingsSubsystem bytes=%llu bindings=%d"),
+				static_cast<uint64>(Sub->GetAllocatedBytes()), Sub->GetNumEventBindings());
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice SSPMemReportCommand(
+	TEXT("ssp.MemReport"),
+	TEXT("Dumps SSPCore memory use per subsystem and USettingsSaveGame creation rate."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		SSPMemoryReport::Dump(World, Ar);
+	}));
@@ -0,0 +1,387 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Containers/Ticker.h"
+#include "Data/SettingsSaveGame.h"
+#include "Dom/JsonObject.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "FuntionLibrary/GeneralSettingsBFL.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Persistence/SettingsPersistence.h"
+#include "Serialization/JsonSerializer.h"
+#include "Subsystems/InputReplaySubsystem.h"
+#include "Subsystems/SettingsSubsystem.h"
+#include "UObject/UObjectGlobals.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace SettingsBenchmark
+{
+	/**
+	 * Forwards everything to the allocator it wraps and counts allocations made on a thread
+	 * while that thread has counting switched on. Installed once and never removed or
+	 * changed, so a thread that read GMalloc before the swap and one that read it after
+	 * reach the same allocator, and nothing other threads do is counted.
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InInner) : Inner(InInner) {}
+
+		static FCountingMalloc& Get()
+		{
+			// Leaked on purpose: other threads keep calling through it until the process ends
+			static FCountingMalloc* Instance = []
+			{
+				FCountingMalloc* Counter = new FCountingMalloc(GMalloc);
+				FPlatformAtomics::InterlockedExchangePtr(reinterpret_cast<void**>(&GMalloc), Counter);
+				return Counter;
+			}();
+			return *Instance;
+		}
+
+		// Counting on the calling thread for the lifetime of the scope
+		struct FScope
+		{
+			FScope() { bCounting = true; NumAllocs = 0; }
+			~FScope() { bCounting = false; }
+			uint64 GetNumAllocs() const { return NumAllocs; }
+		};
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			Note();
+			return Inner->Malloc(Count, Alignment);
+		}
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			Note();
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("SSPBenchCountingMalloc"); }
+
+		// Stays installed, so the allocator's caches and stats must keep working through it
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void MarkTLSCachesAsUsedOnCurrentThread() override { Inner->MarkTLSCachesAsUsedOnCurrentThread(); }
+		virtual void MarkTLSCachesAsUnusedOnCurrentThread() override { Inner->MarkTLSCachesAsUnusedOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void OnPreFork() override { Inner->OnPreFork(); }
+		virtual void OnPostFork() override { Inner->OnPostFork(); }
+		virtual uint64 GetImmediatelyFreeableCachedMemorySize() override { return Inner->GetImmediatelyFreeableCachedMemorySize(); }
+		virtual uint64 GetTotalFreeCachedMemorySize() override { return Inner->GetTotalFreeCachedMemorySize(); }
+
+	private:
+		static void Note()
+		{
+			if (bCounting)
+			{
+				++NumAllocs;
+			}
+		}
+
+		FMalloc* const Inner;
+		static thread_local bool bCounting;
+		static thread_local uint64 NumAllocs;
+	};
+	thread_local bool FCountingMalloc::bCounting = false;
+	thread_local uint64 FCountingMalloc::NumAllocs = 0;
+
+	// Average allocations per call of Query, on the calling thread only
+	template <typename QueryFunc>
+	double CountAllocs(int32 Iterations, QueryFunc&& Query)
+	{
+		FCountingMalloc::Get();
+		const FCountingMalloc::FScope Counting;
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			Query();
+		}
+		return static_cast<double>(Counting.GetNumAllocs()) / FMath::Max(Iterations, 1);
+	}
+
+	// Average microseconds per call of Query
+	template <typename QueryFunc>
+	double TimeQuery(int32 Iterations, QueryFunc&& Query)
+	{
+		const double Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			Query();
+		}
+		return (FPlatformTime::Seconds() - Start) * 1e6 / FMath::Max(Iterations, 1);
+	}
+
+	// Average microseconds per ApplySettings call after Queue runs
+	template <typename QueueFunc>
+	double TimeApply(USettingsSubsystem& Sub, int32 Iterations, QueueFunc&& Queue)
+	{
+		double Total = 0.0;
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			Queue(i);
+			const double Start = FPlatformTime::Seconds();
+			Sub.ApplySettings();
+			Total += FPlatformTime::Seconds() - Start;
+		}
+		return Total * 1e6 / FMath::Max(Iterations, 1);
+	}
+
+	struct FMetric
+	{
+		FString Name;
+		double Value;
+		const TCHAR* Unit;
+	};
+
+	USettingsSubsystem* GetSubsystem(UWorld* World)
+	{
+		UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+		USettingsSubsystem* Sub = GI ? GI->GetSubsystem<USettingsSubsystem>() : nullptr;
+		return Sub && Sub->GetSaveGame() ? Sub : nullptr;
+	}
+
+	// Subsystem the apply metrics can run on, else null with the reason logged
+	USettingsSubsystem* GetIdleSubsystem(UWorld* World, FOutputDevice& Ar)
+	{
+		USettingsSubsystem* Sub = GetSubsystem(World);
+		if (!Sub)
+		{
+			Ar.Logf(TEXT("SSPBench settings subsystem not available"));
+			return nullptr;
+		}
+		if (Sub->HasPendingChanges())
+		{
+			// The first timed apply would apply them, into the scratch store
+			Ar.Logf(TEXT("SSPBench settings have queued changes; apply or revert them first"));
+			return nullptr;
+		}
+		return Sub;
+	}
+
+	// Snapshot writes go to a scratch file in Saved/Profiling while in scope, so the
+	// player's settings slot is never written by a benchmark
+	class FScratchPersistence
+	{
+	public:
+		explicit FScratchPersistence(USettingsSubsystem& InSub)
+			: Sub(InSub)
+			, Saved(InSub.ReplacePersistence(MakeUnique<FSettingsPersistence>(FPaths::ProfilingDir() / TEXT("SSPBench.settings"))))
+		{
+		}
+		~FScratchPersistence()
+		{
+			Sub.ReplacePersistence(MoveTemp(Saved));
+		}
+
+	private:
+		USettingsSubsystem& Sub;
+		TUniquePtr<FSettingsPersistence> Saved;
+	};
+
+	void AddApplyMetrics(USettingsSubsystem& Sub, int32 Iterations, TArray<FMetric>& Out)
+	{
+		const FScratchPersistence Scratch(Sub);
+		const float OriginalBrightness = Sub.GetSaveGame()->Data.Brightness;
+		auto AlternateBrightness = [&Sub, OriginalBrightness](int32 i)
+		{
+			Sub.QueueBrightness((i & 1) ? OriginalBrightness : OriginalBrightness + 0.1f);
+		};
+
+		// Nothing queued: should be a diff and a broadcast, no engine or disk work
+		Out.Add({ TEXT("apply.noop"), TimeApply(Sub, Iterations, [](int32) {}), TEXT("us") });
+		// Re-queue the value that is already applied: still a no-op after the diff
+		Out.Add({ TEXT("apply.same_value"), TimeApply(Sub, Iterations, [&Sub, OriginalBrightness](int32)
+		{
+			Sub.QueueBrightness(OriginalBrightness);
+		}), TEXT("us") });
+		// Alternate brightness so every apply pushes exactly one field and writes the snapshot
+		Out.Add({ TEXT("apply.single_field"), TimeApply(Sub, Iterations, AlternateBrightness), TEXT("us") });
+
+		// Flushed after every apply so coalescing does not hide what one apply costs on disk
+		if (FSettingsPersistence* Persistence = Sub.GetPersistence())
+		{
+			Persistence->Flush();
+			const uint64 BytesBefore = Persistence->GetNumBytesWritten();
+			const uint32 WritesBefore = Persistence->GetNumWrites();
+			for (int32 i = 0; i < Iterations; ++i)
+			{
+				AlternateBrightness(i);
+				Sub.ApplySettings();
+				Persistence->Flush();
+			}
+			Out.Add({ TEXT("apply.bytes_written"), static_cast<double>(Persistence->GetNumBytesWritten() - BytesBefore) / Iterations, TEXT("bytes") });
+			Out.Add({ TEXT("apply.snapshot_writes"), static_cast<double>(Persistence->GetNumWrites() - WritesBefore) / Iterations, TEXT("count") });
+		}
+
+		Sub.QueueBrightness(OriginalBrightness);
+		Sub.ApplySettings();
+	}
+
+	void AddQueryMetrics(USettingsSubsystem& Sub, UWorld* World, int32 Iterations, TArray<FMetric>& Out)
+	{
+		// Cached merge: after the first call this is a lookup, not a copy
+		auto SubsystemSettings = [&Sub] { return Sub.GetCurrentSettingsData().GraphicsQuality; };
+		auto SubsystemSetting = [&Sub] { return Sub.GetSettingValue(GET_MEMBER_NAME_CHECKED(FPendingSettings, Brightness)); };
+		auto SubsystemResolutions = [&Sub] { return Sub.GetAvailableResolutions().Num(); };
+		auto BlueprintResolutions = [World] { return UGeneralSettingsBFL::GetAvailableResolutions(World); };
+
+		Out.Add({ TEXT("query.get_current_settings_data.allocs"), CountAllocs(Iterations, SubsystemSettings), TEXT("count") });
+		Out.Add({ TEXT("query.get_current_settings_data.time"), TimeQuery(Iterations, SubsystemSettings), TEXT("us") });
+		Out.Add({ TEXT("query.get_setting_value.allocs"), CountAllocs(Iterations, SubsystemSetting), TEXT("count") });
+		Out.Add({ TEXT("query.get_setting_value.time"), TimeQuery(Iterations, SubsystemSetting), TEXT("us") });
+		Out.Add({ TEXT("query.get_available_resolutions.allocs"), CountAllocs(Iterations, SubsystemResolutions), TEXT("count") });
+		Out.Add({ TEXT("query.get_available_resolutions.time"), TimeQuery(Iterations, SubsystemResolutions), TEXT("us") });
+		// The Blueprint node returns by value, so this one includes the copy
+		Out.Add({ TEXT("query.bfl_get_available_resolutions.allocs"), CountAllocs(Iterations, BlueprintResolutions), TEXT("count") });
+		Out.Add({ TEXT("query.bfl_get_available_resolutions.time"), TimeQuery(Iterations, BlueprintResolutions), TEXT("us") });
+	}
+
+	void AddStartupMetrics(const USettingsSubsystem& Sub, TArray<FMetric>& Out)
+	{
+		Out.Add({ TEXT("startup.initialize"), Sub.GetInitializeMs(), TEXT("ms") });
+		Out.Add({ TEXT("startup.time_to_ready"), Sub.GetTimeToReadyMs(), TEXT("ms") });
+	}
+
+	// {"suite", "build", "platform", "iterations", "metrics": [{"name", "value", "unit"}]}
+	bool WriteJson(const FString& Path, int32 Iterations, const TArray<FMetric>& Metrics)
+	{
+		TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		Root->SetStringField(TEXT("suite"), TEXT("SSPCore"));
+		Root->SetStringField(TEXT("build"), LexToString(FApp::GetBuildConfiguration()));
+		Root->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+		Root->SetStringField(TEXT("changelist"), FApp::GetBuildVersion());
+		Root->SetNumberField(TEXT("iterations"), Iterations);
+
+		TArray<TSharedPtr<FJsonValue>> Values;
+		for (const FMetric& Metric : Metrics)
+		{
+			TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+			Entry->SetStringField(TEXT("name"), Metric.Name);
+			Entry->SetNumberField(TEXT("value"), Metric.Value);
+			Entry->SetStringField(TEXT("unit"), Metric.Unit);
+			Values.Add(MakeShared<FJsonValueObject>(Entry));
+		}
+		Root->SetArrayField(TEXT("metrics"), Values);
+
+		FString Json;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+		return FJsonSerializer::Serialize(Root, Writer) && FFileHelper::SaveStringToFile(Json, *Path);
+	}
+
+	bool RunSuite(UWorld* World, int32 Iterations, const FString& JsonPath, FOutputDevice& Ar)
+	{
+		USettingsSubsystem* Sub = GetIdleSubsystem(World, Ar);
+		if (!Sub)
+		{
+			return false;
+		}
+
+		TArray<FMetric> Metrics;
+		AddStartupMetrics(*Sub, Metrics);
+		AddApplyMetrics(*Sub, Iterations, Metrics);
+		AddQueryMetrics(*Sub, World, Iterations, Metrics);
+		for (const FMetric& Metric : Metrics)
+		{
+			Ar.Logf(TEXT("SSPBench %s=%.2f %s"), *Metric.Name, Metric.Value, Metric.Unit);
+		}
+
+		const FString Path = JsonPath.IsEmpty()
+			? FPaths::ProfilingDir() / FString::Printf(TEXT("SSPBench-%s.json"), *FDateTime::Now().ToString())
+			: JsonPath;
+		const bool bWritten = WriteJson(Path, Iterations, Metrics);
+		Ar.Logf(TEXT("SSPBench json=%s written=%d"), *Path, bWritten ? 1 : 0);
+		return bWritten;
+	}
+
+	void RunApply(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		USettingsSubsystem* Sub = GetIdleSubsystem(World, Ar);
+		if (!Sub)
+		{
+			return;
+		}
+
+		const int32 Iterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100;
+		TArray<FMetric> Metrics;
+		AddApplyMetrics(*Sub, Iterations, Metrics);
+		Ar.Logf(TEXT("SSPBench apply iterations=%d noop_us=%.2f same_value_us=%.2f single_field_us=%.2f"),
+			Iterations, Metrics[0].Value, Metrics[1].Value, Metrics[2].Value);
+	}
+
+	void Run(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const int32 Iterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100;
+		RunSuite(World, Iterations, Args.Num() > 1 ? Args[1] : FString(), Ar);
+	}
+
+	// -SSPBench[=Path]: once the first map is loaded, settings are ready and any input
+	// playback has finished, run the suite, write the JSON and quit. Exit code 1 on failure.
+	void StartHeadless()
+	{
+		FString JsonPath;
+		if (!FParse::Param(FCommandLine::Get(), TEXT("SSPBench")) && !FParse::Value(FCommandLine::Get(), TEXT("SSPBench="), JsonPath))
+		{
+			return;
+		}
+		int32 Iterations = 100;
+		FParse::Value(FCommandLine::Get(), TEXT("SSPBenchIterations="), Iterations);
+
+		FCoreUObjectDelegates::PostLoadMapWithWorld.AddLambda([JsonPath, Iterations](UWorld* LoadedWorld)
+		{
+			static bool bStarted = false;
+			if (bStarted || !LoadedWorld || !LoadedWorld->GetGameInstance())
+			{
+				return;
+			}
+			bStarted = true;
+			TWeakObjectPtr<UWorld> WeakWorld = LoadedWorld;
+			FTSTicker::GetCoreTicker().AddTicker(TEXT("SSPBench"), 0.f, [WeakWorld, JsonPath, Iterations](float)
+			{
+				UWorld* World = WeakWorld.Get();
+				USettingsSubsystem* Sub = GetSubsystem(World);
+				if (!Sub)
+				{
+					FPlatformMisc::RequestExitWithStatus(false, 1);
+					return false;
+				}
+				const UInputReplaySubsystem* Replay = World->GetGameInstance()->GetSubsystem<UInputReplaySubsystem>();
+				if (!Sub->IsSettingsReady() || (Replay && Replay->IsPlaying()))
+				{
+					return true;
+				}
+				const bool bWritten = RunSuite(World, FMath::Max(1, Iterations), JsonPath, *GLog);
+				FPlatformMisc::RequestExitWithStatus(false, bWritten ? 0 : 1);
+				return false;
+			});
+		});
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice SSPBenchApplyCommand(
+	TEXT("ssp.Bench.Apply"),
+	TEXT("ssp.Bench.Apply [Iterations]: times USettingsSubsystem::ApplySettings for no-op, same-value and single-field changes."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&SettingsBenchmark::RunApply));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice SSPBenchRunCommand(
+	TEXT("ssp.Bench.Run"),
+	TEXT("ssp.Bench.Run [Iterations] [JsonPath]: apply latency, bytes written per apply, allocations per query and startup cost, as JSON (default Saved/Profiling)."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&SettingsBenchmark::Run));
+
+static FDelayedAutoRegisterHelper GSSPBenchHeadless(EDelayedRegisterRunPhase::EndOfEngineInit, &SettingsBenchmark::StartHeadless);
+
+#endif
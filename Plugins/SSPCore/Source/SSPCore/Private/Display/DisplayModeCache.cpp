@@ -0,0 +1,123 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Display/DisplayModeCache.h"
+
+#include "RHI.h"
+
+void FDisplayModeCache::Rebuild(const FDisplayMetrics& Metrics)
+{
+	Modes.Reset();
+	ModeLabels.Reset();
+	ModeToIndex.Reset();
+	Resolutions.Reset();
+	ResolutionLabels.Reset();
+	ResolutionToIndex.Reset();
+	LegacyResolutions.Reset();
+	Monitors.Reset();
+
+	FScreenResolutionArray RHIModes;
+	RHIGetAvailableResolutions(RHIModes, false);
+	TSet<FSettingsDisplayMode> Unique;
+	Unique.Reserve(RHIModes.Num());
+	TSet<FIntPoint> LegacySeen;
+	for (const FScreenResolutionRHI& R : RHIModes)
+	{
+		Unique.Add({ static_cast<int32>(R.Width), static_cast<int32>(R.Height), static_cast<int32>(R.RefreshRate) });
+		// The old resolution list: sizes in RHI order, first occurrence wins
+		bool bSeen = false;
+		LegacySeen.Add(FIntPoint(R.Width, R.Height), &bSeen);
+		if (!bSeen)
+		{
+			LegacyResolutions.Add(FIntPoint(R.Width, R.Height));
+		}
+	}
+	Modes = Unique.Array();
+	Modes.Sort([](const FSettingsDisplayMode& A, const FSettingsDisplayMode& B)
+	{
+		if (A.Width != B.Width) return A.Width < B.Width;
+		if (A.Height != B.Height) return A.Height < B.Height;
+		return A.RefreshRate < B.RefreshRate;
+	});
+
+	ModeLabels.Reserve(Modes.Num());
+	for (int32 i = 0; i < Modes.Num(); ++i)
+	{
+		const FSettingsDisplayMode& Mode = Modes[i];
+		ModeToIndex.Add(Mode, i);
+		ModeLabels.Add(Mode.RefreshRate > 0
+			? FString::Printf(TEXT("%d x %d @ %d Hz"), Mode.Width, Mode.Height, Mode.RefreshRate)
+			: FString::Printf(TEXT("%d x %d"), Mode.Width, Mode.Height));
+
+		// Sorted, so the refresh rates of one size are adjacent
+		if (Resolutions.Num() == 0 || Resolutions.Last() != Mode.GetResolution())
+		{
+			ResolutionToIndex.Add(Mode.GetResolution(), Resolutions.Add(Mode.GetResolution()));
+			ResolutionLabels.Add(FString::Printf(TEXT("%d x %d"), Mode.Width, Mode.Height));
+		}
+	}
+
+	for (const FMonitorInfo& Info : Metrics.MonitorInfo)
+	{
+		FSettingsMonitor& Monitor = Monitors.AddDefaulted_GetRef();
+		Monitor.Name = Info.Name;
+		Monitor.NativeResolution = FIntPoint(Info.NativeWidth, Info.NativeHeight);
+		Monitor.bIsPrimary = Info.bIsPrimary;
+		Monitor.DisplayRect = Info.DisplayRect;
+	}
+}
+
+int32 FDisplayModeCache::FindMode(const FSettingsDisplayMode& Mode) const
+{
+	const int32* Index = ModeToIndex.Find(Mode);
+	return Index ? *Index : INDEX_NONE;
+}
+
+int32 FDisplayModeCache::FindResolution(const FIntPoint& Resolution) const
+{
+	const int32* Index = ResolutionToIndex.Find(Resolution);
+	return Index ? *Index : INDEX_NONE;
+}
+
+FIntPoint FDisplayModeCache::GetLegacyResolution(int32 Index) const
+{
+	return LegacyResolutions.IsValidIndex(Index) ? LegacyResolutions[Index] : FIntPoint::ZeroValue;
+}
+
+int32 FDisplayModeCache::FindMonitor(const FIntPoint& ScreenPoint) const
+{
+	int32 Primary = INDEX_NONE;
+	for (int32 i = 0; i < Monitors.Num(); ++i)
+	{
+		const FPlatformRect& Rect = Monitors[i].DisplayRect;
+		if (ScreenPoint.X >= Rect.Left && ScreenPoint.X < Rect.Right && ScreenPoint.Y >= Rect.Top && ScreenPoint.Y < Rect.Bottom)
+		{
+			return i;
+		}
+		if (Monitors[i].bIsPrimary)
+		{
+			Primary = i;
+		}
+	}
+	return Primary;
+}
+
+SIZE_T FDisplayModeCache::GetAllocatedSize() const
+{
+	SIZE_T Bytes = Modes.GetAllocatedSize() + ModeLabels.GetAllocatedSize() + ModeToIndex.GetAllocatedSize()
+		+ Resolutions.GetAllocatedSize() + ResolutionLabels.GetAllocatedSize() + ResolutionToIndex.GetAllocatedSize()
+		+ LegacyResolutions.GetAllocatedSize() + Monitors.GetAllocatedSize();
+	for (const FString& Label : ModeLabels)
+	{
+		Bytes += Label.GetAllocatedSize();
+	}
+	for (const FString& Label : ResolutionLabels)
+	{
+		Bytes += Label.GetAllocatedSize();
+	}
+	for (const FSettingsMonitor& Monitor : Monitors)
+	{
+		Bytes += Monitor.Name.GetAllocatedSize();
+	}
+	return Bytes;
+}
@@ -26,8 +26,10 @@
 
 #include "FuntionLibrary/GeneralSettingsBFL.h"
 
+#include "Data/SettingsPreset.h"
 #include "GameFramework/GameUserSettings.h"
 #include "Kismet/GameplayStatics.h"
+#include "Subsystems/InputSettingsSubsystem.h"
 #include "Subsystems/SettingsSubsystem.h"
 
 /**
@@ -88,14 +90,58 @@ USettingsSubsystem* UGeneralSettingsBFL::GetSettingsSubsystem(const UObject* Wor
 	return GI->GetSubsystem<USettingsSubsystem>();
 }
 
+UInputSettingsSubsystem* UGeneralSettingsBFL::GetInputSettingsSubsystem(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+	return GI ? GI->GetSubsystem<UInputSettingsSubsystem>() : nullptr;
+}
+
+/**
+ * Sets the base sound mix used for volume overrides.
+ *
+ * The same mix receives every channel's volume override; it is pushed
+ * once and then updated in place.
+ *
+ * Saved settings are loaded by USettingsSubsystem itself when the game
+ * instance starts; bind OnSettingsReady (or check IsSettingsReady)
+ * before reading them into widgets.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param SoundMix
+ *      Mix that holds the per-class volume overrides.
+ */
 void UGeneralSettingsBFL::InitSettings(const UObject* WorldContextObject, USoundMix* SoundMix)
 {
 	UGameplayStatics::SetBaseSoundMix(WorldContextObject, SoundMix);
 	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
 	{
-		FSubsystemCollection<USettingsSubsystem> Collection;
-		Sub->Initialize(Collection);
+		Sub->SetVolumeSoundMix(SoundMix);
+	}
+}
+
+/**
+ * Returns whether saved settings have finished loading and been applied.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @return
+ *      False while the save slot is still loading, or if the settings
+ *      subsystem is unavailable.
+ *
+ * @usage (Blueprint)
+ *      Branch on IsSettingsReady, otherwise bind OnSettingsReady
+ */
+bool UGeneralSettingsBFL::IsSettingsReady(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->IsSettingsReady();
 	}
+	return false;
 }
 
 /**
@@ -193,6 +239,117 @@ void UGeneralSettingsBFL::UpdateVolumeSettings(const UObject* WorldContextObject
 	}
 }
 
+/**
+ * Queues a volume change for any channel in the audio channel table.
+ *
+ * Channels (Music, Ambience, UI, Voice…) and their sound classes are
+ * listed in DefaultGame.ini under [/Script/SSPCore.SettingsSubsystem];
+ * Master, SFX and Dialogue are always available.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param Channel
+ *      Channel name from GetAudioChannels().
+ *
+ * @param Level
+ *      Volume value in the range 0.0 – 1.0.
+ *
+ * @note
+ *      Call SaveSettings() to apply and persist it.
+ *
+ * @usage (Blueprint)
+ *      OnValueChanged (Slider)
+ *      → UpdateChannelVolume
+ */
+void UGeneralSettingsBFL::UpdateChannelVolume(const UObject* WorldContextObject, FName Channel, float Level)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		Sub->QueueChannelVolume(Channel, Level);
+	}
+}
+
+/**
+ * Queues a channel volume and lets the player hear it while dragging.
+ *
+ * The mix is updated in memory at most once per ssp.Audio.PreviewInterval
+ * seconds, however often the slider fires. Nothing is written to disk.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param Channel
+ *      Channel name from GetAudioChannels().
+ *
+ * @param Level
+ *      Volume value in the range 0.0 – 1.0.
+ *
+ * @note
+ *      SaveSettings() persists the value, RevertPendingSettings on the
+ *      subsystem restores the saved one.
+ *
+ * @usage (Blueprint)
+ *      OnValueChanged (Slider)
+ *      → PreviewChannelVolume
+ */
+void UGeneralSettingsBFL::PreviewChannelVolume(const UObject* WorldContextObject, FName Channel, float Level)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		Sub->PreviewChannelVolume(Channel, Level);
+	}
+}
+
+/**
+ * Returns a channel's volume, including any queued change.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param Channel
+ *      Channel name from GetAudioChannels().
+ *
+ * @return
+ *      Volume in the range 0.0 – 1.0, the channel's default if it
+ *      was never set, or 0 if the settings subsystem is unavailable.
+ *
+ * @usage (Blueprint)
+ *      GetChannelVolume(Self, "Music")
+ *      → SetValue (Slider)
+ */
+float UGeneralSettingsBFL::GetChannelVolume(const UObject* WorldContextObject, FName Channel)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->GetChannelVolume(Channel);
+	}
+	return 0.0f;
+}
+
+/**
+ * Returns the names of every configured or registered audio channel.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @return
+ *      Channel names in config order, then channels registered at runtime.
+ *
+ * @usage (Blueprint)
+ *      GetAudioChannels(Self)
+ *      → ForEachLoop
+ *      → Create Slider Widget
+ */
+TArray<FName> UGeneralSettingsBFL::GetAudioChannels(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->GetAudioChannels();
+	}
+	return {};
+}
+
 /**
  * Queues a brightness (gamma) change without immediately applying it.
  *
@@ -225,216 +382,960 @@ void UGeneralSettingsBFL::UpdateBrightnessSettings(const UObject* WorldContextOb
 }
 
 /**
- * Applies and saves all queued settings.
- *
- * This function commits all pending changes stored in the
- * USettingsSubsystem and applies them to the engine.
- * Settings are also saved so they persist between game sessions.
- *
- * Affected systems:
- * - Graphics quality
- * - Resolution & window mode
- * - Brightness (gamma)
- * - Audio volumes
+ * Queues a frame rate cap without immediately applying it.
  *
  * @param WorldContextObject
  *      Any UObject that provides a valid world context.
  *
+ * @param FramesPerSecond
+ *      Maximum frames per second. 0 removes the cap.
+ *
  * @note
- *      This should typically be called when the user presses
- *      an "Apply" or "Save" button in the settings menu.
+ *      Applied on SaveSettings(), no restart required.
  *
  * @usage (Blueprint)
- *      OnClicked (Apply Button)
- *      → SaveSettings
+ *      OnSelectionChanged (ComboBox: 30 / 60 / 120 / Unlimited)
+ *      → UpdateFrameRateLimit
  */
-void UGeneralSettingsBFL::SaveSettings(const UObject* WorldContextObject)
+void UGeneralSettingsBFL::UpdateFrameRateLimit(const UObject* WorldContextObject, float FramesPerSecond)
 {
 	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
 	{
-		Sub->ApplySettings();
+		Sub->QueueFrameRateLimit(FramesPerSecond);
 	}
 }
 
-void UGeneralSettingsBFL::SaveSoundSettings(const UObject* WorldContextObject, USoundMix* SoundMix,
-	USoundClass* SoundClass, EVolumeType SoundType)
+/**
+ * Queues a VSync change without immediately applying it.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param bEnabled
+ *      True to synchronise presents with the display refresh.
+ *
+ * @usage (Blueprint)
+ *      OnCheckStateChanged (CheckBox)
+ *      → UpdateVSync
+ */
+void UGeneralSettingsBFL::UpdateVSync(const UObject* WorldContextObject, bool bEnabled)
 {
 	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
 	{
-		Sub->ApplySoundSettings(SoundMix, SoundClass, SoundType);
+		Sub->QueueVSync(bEnabled);
 	}
 }
 
 /**
- * Resets all settings to their default values and applies them immediately.
- *
- * This function restores predefined default settings
- * (graphics, audio, brightness, etc.), applies them to the engine,
- * and saves them for future sessions.
+ * Queues a fixed render resolution scale without immediately applying it.
  *
  * @param WorldContextObject
  *      Any UObject that provides a valid world context.
  *
+ * @param Percentage
+ *      Render resolution as a percentage of the output resolution.
+ *      Clamped to 10 – 200 when applied.
+ *
  * @note
- *      This action overrides any queued changes.
- *      Defaults are defined in USettingsSubsystem.
+ *      Used while dynamic resolution is off.
  *
  * @usage (Blueprint)
- *      OnClicked (Reset Button)
- *      → ResetSettingsToDefault
+ *      OnValueChanged (Slider)
+ *      → UpdateScreenPercentage
  */
-void UGeneralSettingsBFL::ResetSettingsToDefault(const UObject* WorldContextObject)
+void UGeneralSettingsBFL::UpdateScreenPercentage(const UObject* WorldContextObject, float Percentage)
 {
 	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
 	{
-		Sub->ResetToDefaults();
+		Sub->QueueScreenPercentage(Percentage);
 	}
 }
 
 /**
- * Returns a list of display resolutions supported by the current system.
+ * Queues dynamic resolution and its budget without immediately applying them.
  *
- * This function is intended for populating resolution dropdowns
- * in UMG settings menus.
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param bEnabled
+ *      True to let the engine scale render resolution to fit the budget.
+ *
+ * @param MinScreenPercentage
+ *      Lowest screen percentage dynamic resolution may drop to.
+ *
+ * @param MaxScreenPercentage
+ *      Highest screen percentage dynamic resolution may reach.
+ *
+ * @param FrameTimeBudgetMs
+ *      GPU frame time, in milliseconds, the resolution is scaled to fit.
+ *
+ * @usage (Blueprint)
+ *      OnCheckStateChanged (CheckBox)
+ *      → UpdateDynamicResolution
+ */
+void UGeneralSettingsBFL::UpdateDynamicResolution(const UObject* WorldContextObject, bool bEnabled,
+	float MinScreenPercentage, float MaxScreenPercentage, float FrameTimeBudgetMs)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		Sub->QueueDynamicResolution(bEnabled);
+		Sub->QueueDynamicResolutionBudget(MinScreenPercentage, MaxScreenPercentage, FrameTimeBudgetMs);
+	}
+}
+
+/**
+ * Queues a latency mode change without immediately applying it.
  *
  * @param WorldContextObject
  *      Any UObject that provides a valid world context.
- *      Usually the calling UUserWidget (Self).
  *
- * @return
- *      Array of formatted resolution strings.
- *      Example:
- *          ["1920 x 1080", "2560 x 1440", "3840 x 2160"]
+ * @param Mode
+ *      Off keeps the engine's frame pipelining.
+ *      On and Boost trade throughput for lower input latency.
  *
- *      Returns an empty array if the settings subsystem is unavailable.
+ * @note
+ *      Thread sync changes on the next frame after ApplySettings.
+ *      Queued frames are only limited on RHIs that expose the setting (D3D12),
+ *      and only once the swapchain is recreated: next window mode change or restart.
  *
  * @usage (Blueprint)
- *      GetAvailableResolutions(Self)
- *      → ForEachLoop
- *      → AddOption (ComboBoxString)
+ *      OnSelectionChanged (ComboBox: Off / On / Boost)
+ *      → UpdateLatencyMode
  */
-TArray<FString> UGeneralSettingsBFL::GetAvailableResolutions(const UObject* WorldContextObject)
+void UGeneralSettingsBFL::UpdateLatencyMode(const UObject* WorldContextObject, ELatencyMode Mode)
 {
 	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
 	{
-		return Sub->GetAvailableResolutions();
+		Sub->QueueLatencyMode(Mode);
 	}
-	return {};
 }
 
 /**
- * Returns the list of supported Graphics.
+ * Returns the latency mode, including a queued change.
  *
- * Index mapping:
- *      0 → Low
- *      1 → Medium
- *      2 → High
- *      3 → Epic
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
  *
  * @return
- *      Array of graphic display strings.
+ *      Current mode, or Off if the settings subsystem is unavailable.
  *
  * @usage (Blueprint)
- *      GetGraphics()
- *      → AddOption (ComboBoxString)
+ *      Event Construct
+ *      → GetLatencyMode → SetSelectedIndex (ComboBox)
  */
-TArray<FString> UGeneralSettingsBFL::GetGraphics()
+ELatencyMode UGeneralSettingsBFL::GetLatencyMode(const UObject* WorldContextObject)
 {
-	return {
-		TEXT("Low"),
-		TEXT("Medium"),
-		TEXT("High"),
-		TEXT("Epic")
-	};
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		const float Mode = Sub->GetSettingValue(GET_MEMBER_NAME_CHECKED(FPendingSettings, LatencyMode));
+		return static_cast<ELatencyMode>(FMath::Clamp(FMath::RoundToInt(Mode), 0, static_cast<int32>(ELatencyMode::Boost)));
+	}
+	return ELatencyMode::Off;
 }
 
 /**
- * Returns the index of the currently active screen resolution.
- *
- * The returned index matches the position of the resolution
- * within the array returned by GetAvailableResolutions().
+ * Queues streaming pool sizes without immediately applying them.
  *
  * @param WorldContextObject
  *      Any UObject that provides a valid world context.
  *
- * @return
- *      Index of the active resolution.
- *      Returns INDEX_NONE (-1) if:
- *          - Resolution is not found
- *          - Settings subsystem is unavailable
+ * @param TexturePoolSizeMB
+ *      Texture streaming pool in MB. 0 restores the engine default.
+ *
+ * @param MeshPoolSizeMB
+ *      Mesh streaming pool in MB. 0 restores the engine default,
+ *      which normally shares the texture pool.
+ *
+ * @note
+ *      The texture pool is sized from installed memory on first run.
+ *      Presets do not change either pool.
  *
  * @usage (Blueprint)
- *      GetCurrentResolutionIndex(Self)
- *      → SetSelectedIndex (ComboBoxString)
+ *      OnMemoryPressureChanged → Pressure.RecommendedPoolSizeMB
+ *      → UpdateMemoryBudgets → SaveSettings
  */
-int32 UGeneralSettingsBFL::GetCurrentResolutionIndex(const UObject* WorldContextObject)
+void UGeneralSettingsBFL::UpdateMemoryBudgets(const UObject* WorldContextObject, int32 TexturePoolSizeMB, int32 MeshPoolSizeMB)
 {
 	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
 	{
-		return Sub->GetCurrentResolutionIndex();
+		Sub->QueueTexturePoolSize(TexturePoolSizeMB);
+		Sub->QueueMeshPoolSize(MeshPoolSizeMB);
 	}
-	return INDEX_NONE;
 }
 
 /**
- * Returns the list of supported window modes.
+ * Returns the last texture streaming pool sample.
  *
- * Index mapping:
- *      0 → Fullscreen
- *      1 → Windowed
- *      2 → Borderless (Windowed Fullscreen)
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
  *
  * @return
- *      Array of window mode display strings.
+ *      Pool size, overrun and a recommended pool size while over budget.
+ *      Empty if the settings subsystem is unavailable or streaming is off.
+ *
+ * @note
+ *      Sampled every ssp.Memory.PollInterval seconds. Bind OnMemoryPressureChanged
+ *      on the settings subsystem to be told about changes instead.
  *
  * @usage (Blueprint)
- *      GetWindowModes()
- *      → AddOption (ComboBoxString)
+ *      Event Construct
+ *      → GetMemoryPressure → Branch (bOverBudget) → Show hint
  */
-TArray<FString> UGeneralSettingsBFL::GetWindowModes()
+FSettingsMemoryPressure UGeneralSettingsBFL::GetMemoryPressure(const UObject* WorldContextObject)
 {
-	return {
-		TEXT("Fullscreen"),
-		TEXT("Windowed"),
-		TEXT("Borderless")
-	};
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->GetMemoryPressure();
+	}
+	return FSettingsMemoryPressure();
 }
 
 /**
- * Returns the currently active window mode as an index.
+ * Returns the largest texture pool this machine can afford.
  *
- * Index mapping:
- *      0 → Fullscreen
- *      1 → Windowed
- *      2 → Borderless (Windowed Fullscreen)
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
  *
  * @return
- *      Index representing the active window mode.
- *      Defaults to Windowed (1) if engine settings are unavailable.
+ *      Limit in MB from installed RAM and video memory,
+ *      or 0 if the settings subsystem is unavailable.
  *
  * @usage (Blueprint)
- *      GetCurrentWindowMode()
- *      → SetSelectedIndex (ComboBoxString)
+ *      Event Construct
+ *      → GetTexturePoolLimit → SetMaxValue (Slider)
  */
-int32 UGeneralSettingsBFL::GetCurrentWindowMode()
+int32 UGeneralSettingsBFL::GetTexturePoolLimit(const UObject* WorldContextObject)
 {
-	if (!GEngine)
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
 	{
-		return 1; // default Windowed
+		return Sub->GetTexturePoolLimitMB();
 	}
-	switch (GEngine->GetGameUserSettings()->GetFullscreenMode())
-	{
-	case EWindowMode::Fullscreen:
-		return 0;
-	case EWindowMode::Windowed:
-		return 1;
-	case EWindowMode::WindowedFullscreen:
+	return 0;
+}
+
+/**
+ * Returns the hardware tier this machine was classified as on first run.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @return
+ *      Tier from the HardwareTiers table, or Unknown before settings are ready
+ *      or if the settings subsystem is unavailable.
+ *
+ * @note
+ *      The tier picks the default performance settings and is kept in the save,
+ *      so Reset to Defaults returns to the same values on this machine.
+ *
+ * @usage (Blueprint)
+ *      Event Construct
+ *      → GetHardwareTier → Select → SetText ("Recommended: High")
+ */
+EHardwareTier UGeneralSettingsBFL::GetHardwareTier(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->GetHardwareTier();
+	}
+	return EHardwareTier::Unknown;
+}
+
+/**
+ * Returns the performance presets configured for the project.
+ *
+ * Presets are USettingsPreset data assets listed in DefaultGame.ini:
+ *      [/Script/SSPCore.SettingsSubsystem]
+ *      +PresetAssets=/Game/Settings/DA_BatterySaver.DA_BatterySaver
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @return
+ *      Loaded presets in config order. Empty while they are still
+ *      loading or if the settings subsystem is unavailable.
+ *
+ * @usage (Blueprint)
+ *      GetSettingsPresets(Self)
+ *      → ForEachLoop
+ *      → AddOption (DisplayName)
+ */
+TArray<USettingsPreset*> UGeneralSettingsBFL::GetSettingsPresets(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return TArray<USettingsPreset*>(Sub->GetPresets());
+	}
+	return {};
+}
+
+/**
+ * Applies and saves a performance preset in a single pass.
+ *
+ * Scalability, screen percentage, frame rate cap, VSync and dynamic
+ * resolution all come from the preset and reach the engine together.
+ * Resolution, window mode, brightness and volumes are left alone.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param Preset
+ *      Preset to apply. Ignored if null.
+ *
+ * @note
+ *      Other settings already queued are applied in the same pass.
+ *
+ * @usage (Blueprint)
+ *      OnClicked (Preset Button)
+ *      → ApplySettingsPreset
+ */
+void UGeneralSettingsBFL::ApplySettingsPreset(const UObject* WorldContextObject, USettingsPreset* Preset)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		Sub->ApplyPreset(Preset);
+	}
+}
+
+/**
+ * Returns the preset matching the currently applied settings.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @return
+ *      The matching preset, or null if the player's values
+ *      match none of them (show "Custom").
+ *
+ * @usage (Blueprint)
+ *      GetActiveSettingsPreset(Self)
+ *      → IsValid → highlight preset / show "Custom"
+ */
+USettingsPreset* UGeneralSettingsBFL::GetActiveSettingsPreset(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->GetActivePreset();
+	}
+	return nullptr;
+}
+
+/**
+ * Shows queued brightness and dynamic resolution budget changes
+ * immediately, without saving them.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @note
+ *      SaveSettings() keeps the previewed values;
+ *      RevertPendingSettings on the subsystem restores the applied ones.
+ *
+ * @usage (Blueprint)
+ *      OnValueChanged (Brightness Slider)
+ *      → UpdateBrightnessSettings
+ *      → PreviewSettings
+ */
+void UGeneralSettingsBFL::PreviewSettings(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		Sub->PreviewPendingSettings();
+	}
+}
+
+/**
+ * Applies and saves all queued settings.
+ *
+ * This function commits all pending changes stored in the
+ * USettingsSubsystem and applies them to the engine.
+ * Settings are also saved so they persist between game sessions.
+ *
+ * Affected systems:
+ * - Graphics quality
+ * - Resolution & window mode
+ * - Brightness (gamma)
+ * - Frame rate cap, VSync, screen percentage, dynamic resolution
+ * - Audio volumes
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @note
+ *      This should typically be called when the user presses
+ *      an "Apply" or "Save" button in the settings menu.
+ *
+ * @usage (Blueprint)
+ *      OnClicked (Apply Button)
+ *      → SaveSettings
+ */
+void UGeneralSettingsBFL::SaveSettings(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		Sub->ApplySettings();
+	}
+}
+
+void UGeneralSettingsBFL::SaveSoundSettings(const UObject* WorldContextObject, USoundMix* SoundMix,
+	USoundClass* SoundClass, EVolumeType SoundType)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		Sub->ApplySoundSettings(SoundMix, SoundClass, SoundType);
+	}
+}
+
+/**
+ * Resets all settings to their default values and applies them immediately.
+ *
+ * This function restores predefined default settings
+ * (graphics, audio, brightness, etc.), applies them to the engine,
+ * and saves them for future sessions.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @note
+ *      This action overrides any queued changes.
+ *      Defaults are defined in USettingsSubsystem.
+ *
+ * @usage (Blueprint)
+ *      OnClicked (Reset Button)
+ *      → ResetSettingsToDefault
+ */
+void UGeneralSettingsBFL::ResetSettingsToDefault(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		Sub->ResetToDefaults();
+	}
+}
+
+/**
+ * Returns a list of display resolutions supported by the current system.
+ *
+ * This function is intended for populating resolution dropdowns
+ * in UMG settings menus.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *      Usually the calling UUserWidget (Self).
+ *
+ * @return
+ *      Array of formatted resolution strings.
+ *      Example:
+ *          ["1920 x 1080", "2560 x 1440", "3840 x 2160"]
+ *
+ *      Returns an empty array if the settings subsystem is unavailable.
+ *
+ * @usage (Blueprint)
+ *      GetAvailableResolutions(Self)
+ *      → ForEachLoop
+ *      → AddOption (ComboBoxString)
+ */
+TArray<FString> UGeneralSettingsBFL::GetAvailableResolutions(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->GetAvailableResolutions();
+	}
+	return {};
+}
+
+/**
+ * Returns the list of supported Graphics.
+ *
+ * Index mapping:
+ *      0 → Low
+ *      1 → Medium
+ *      2 → High
+ *      3 → Epic
+ *
+ * @return
+ *      Array of graphic display strings.
+ *
+ * @usage (Blueprint)
+ *      GetGraphics()
+ *      → AddOption (ComboBoxString)
+ */
+TArray<FString> UGeneralSettingsBFL::GetGraphics()
+{
+	return {
+		TEXT("Low"),
+		TEXT("Medium"),
+		TEXT("High"),
+		TEXT("Epic")
+	};
+}
+
+/**
+ * Queues a level for one scalability group without immediately applying it.
+ *
+ * Lets players drop expensive groups (shadows, GI, reflections, foliage)
+ * while keeping others such as textures high. Once groups differ the
+ * overall Graphics Quality reads as Custom.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param Group
+ *      Scalability group to change.
+ *
+ * @param Level
+ *      Same scale as GetGraphics(): 0 → Low … 3 → Epic.
+ *
+ * @note
+ *      Queuing an overall Graphics Quality afterwards replaces
+ *      any group levels queued before it.
+ *
+ * @usage (Blueprint)
+ *      OnSelectionChanged (ComboBox per group)
+ *      → UpdateScalabilityGroup
+ */
+void UGeneralSettingsBFL::UpdateScalabilityGroup(const UObject* WorldContextObject, EScalabilityGroup Group, int32 Level)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		Sub->QueueScalabilityGroup(Group, Level);
+	}
+}
+
+/**
+ * Returns the level of one scalability group, including queued changes.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param Group
+ *      Scalability group to read.
+ *
+ * @return
+ *      Level index for GetGraphics(), or INDEX_NONE (-1)
+ *      if the settings subsystem is unavailable.
+ *
+ * @usage (Blueprint)
+ *      GetScalabilityGroupLevel(Self, Shadows)
+ *      → SetSelectedIndex (ComboBoxString)
+ */
+int32 UGeneralSettingsBFL::GetScalabilityGroupLevel(const UObject* WorldContextObject, EScalabilityGroup Group)
+{
+	if (Group == EScalabilityGroup::Num)
+	{
+		return INDEX_NONE;
+	}
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->GetScalabilityGroupLevel(Group);
+	}
+	return INDEX_NONE;
+}
+
+/**
+ * Returns whether the scalability groups no longer share one level.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @return
+ *      True when the groups (including queued changes) differ,
+ *      so the overall Graphics Quality should display as "Custom".
+ *
+ * @usage (Blueprint)
+ *      Branch on IsCustomGraphicsQuality
+ *      → show "Custom" in the Graphics Quality combo box
+ */
+bool UGeneralSettingsBFL::IsCustomGraphicsQuality(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->GetSettingValue(GET_MEMBER_NAME_CHECKED(FPendingSettings, GraphicsQuality)) < 0.0f;
+	}
+	return false;
+}
+
+/**
+ * Returns the index of the currently active screen resolution.
+ *
+ * The returned index matches the position of the resolution
+ * within the array returned by GetAvailableResolutions().
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @return
+ *      Index of the active resolution.
+ *      Returns INDEX_NONE (-1) if:
+ *          - Resolution is not found
+ *          - Settings subsystem is unavailable
+ *
+ * @usage (Blueprint)
+ *      GetCurrentResolutionIndex(Self)
+ *      → SetSelectedIndex (ComboBoxString)
+ */
+int32 UGeneralSettingsBFL::GetCurrentResolutionIndex(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->GetCurrentResolutionIndex();
+	}
+	return INDEX_NONE;
+}
+
+/**
+ * Returns every connected monitor.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @return
+ *      Monitors with their name, native resolution and whether they are primary.
+ *      Refreshed automatically when a monitor is plugged in or removed.
+ *
+ * @usage (Blueprint)
+ *      GetMonitors(Self)
+ *      → ForEachLoop
+ *      → AddOption (ComboBoxString, Name)
+ */
+TArray<FSettingsMonitor> UGeneralSettingsBFL::GetMonitors(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return TArray<FSettingsMonitor>(Sub->GetDisplayModes().GetMonitors());
+	}
+	return {};
+}
+
+/**
+ * Returns the index of the monitor the game window is on.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @return
+ *      Index into GetMonitors(), the primary monitor if the window
+ *      position is unknown, or INDEX_NONE (-1) if there is no monitor.
+ */
+int32 UGeneralSettingsBFL::GetCurrentMonitor(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->GetCurrentMonitorIndex();
+	}
+	return INDEX_NONE;
+}
+
+/**
+ * Returns the display modes (size and refresh rate) the game can switch to.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @return
+ *      Modes sorted by width, height, then refresh rate.
+ *      Same order as GetDisplayModeLabels().
+ *
+ * @note
+ *      The RHI only enumerates the primary display output,
+ *      so the list is the same whichever monitor the window is on.
+ *
+ * @usage (Blueprint)
+ *      GetDisplayModes(Self)
+ *      → Get (ComboBox selected index)
+ *      → UpdateDisplayMode
+ */
+TArray<FSettingsDisplayMode> UGeneralSettingsBFL::GetDisplayModes(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return TArray<FSettingsDisplayMode>(Sub->GetDisplayModes().GetModes());
+	}
+	return {};
+}
+
+/**
+ * Returns labels for GetDisplayModes(), e.g. "2560 x 1440 @ 144 Hz".
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @return
+ *      One label per mode, in the same order as GetDisplayModes().
+ *
+ * @usage (Blueprint)
+ *      GetDisplayModeLabels(Self)
+ *      → ForEachLoop
+ *      → AddOption (ComboBoxString)
+ */
+TArray<FString> UGeneralSettingsBFL::GetDisplayModeLabels(const UObject* WorldContextObject)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->GetDisplayModes().GetModeLabels();
+	}
+	return {};
+}
+
+/**
+ * Queues the size and refresh rate of a display mode.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param Mode
+ *      An entry from GetDisplayModes().
+ *
+ * @note
+ *      The mode is saved as size and rate, so it survives the list changing.
+ *      The RHI lets the driver pick the swapchain rate; in exclusive fullscreen
+ *      a lower chosen rate is held with the frame rate limit instead.
+ *      Call SaveSettings() to apply.
+ */
+void UGeneralSettingsBFL::UpdateDisplayMode(const UObject* WorldContextObject, const FSettingsDisplayMode& Mode)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		Sub->QueueDisplayMode(Mode);
+	}
+}
+
+/**
+ * Returns the list of supported window modes.
+ *
+ * Index mapping:
+ *      0 → Fullscreen
+ *      1 → Windowed
+ *      2 → Borderless (Windowed Fullscreen)
+ *
+ * @return
+ *      Array of window mode display strings.
+ *
+ * @usage (Blueprint)
+ *      GetWindowModes()
+ *      → AddOption (ComboBoxString)
+ */
+TArray<FString> UGeneralSettingsBFL::GetWindowModes()
+{
+	return {
+		TEXT("Fullscreen"),
+		TEXT("Windowed"),
+		TEXT("Borderless")
+	};
+}
+
+/**
+ * Returns the currently active window mode as an index.
+ *
+ * Index mapping:
+ *      0 → Fullscreen
+ *      1 → Windowed
+ *      2 → Borderless (Windowed Fullscreen)
+ *
+ * @return
+ *      Index representing the active window mode.
+ *      Defaults to Windowed (1) if engine settings are unavailable.
+ *
+ * @usage (Blueprint)
+ *      GetCurrentWindowMode()
+ *      → SetSelectedIndex (ComboBoxString)
+ */
+int32 UGeneralSettingsBFL::GetCurrentWindowMode()
+{
+	if (!GEngine)
+	{
+		return 1; // default Windowed
+	}
+	switch (GEngine->GetGameUserSettings()->GetFullscreenMode())
+	{
+	case EWindowMode::Fullscreen:
+		return 0;
+	case EWindowMode::Windowed:
+		return 1;
+	case EWindowMode::WindowedFullscreen:
 		return 2;
 	default:
 		return 1;
 	}
 }
 
+/**
+ * Queues any setting in the settings schema by key.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param Key
+ *      Field name in FPendingSettings (e.g. "FrameRateLimit"),
+ *      or a key registered with FSettingsSchema from C++.
+ *
+ * @param Value
+ *      New value. Clamped to the schema range; bools use 0 / 1.
+ *
+ * @note
+ *      Unknown keys are logged and ignored.
+ *      Call SaveSettings to apply.
+ *
+ * @usage (Blueprint)
+ *      OnValueChanged (Slider)
+ *      → UpdateSetting(Self, "FieldOfView", Value)
+ */
+void UGeneralSettingsBFL::UpdateSetting(const UObject* WorldContextObject, FName Key, float Value)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		Sub->QueueSetting(Key, Value);
+	}
+}
+
+/**
+ * Returns the value of any setting in the settings schema, including queued changes.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param Key
+ *      Same keys as UpdateSetting.
+ *
+ * @return
+ *      Current value, or 0 if the key is unknown
+ *      or the settings subsystem is unavailable.
+ *
+ * @usage (Blueprint)
+ *      GetSettingValue(Self, "FieldOfView")
+ *      → SetValue (Slider)
+ */
+float UGeneralSettingsBFL::GetSettingValue(const UObject* WorldContextObject, FName Key)
+{
+	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->GetSettingValue(Key);
+	}
+	return 0.0f;
+}
+
+/**
+ * Returns every rebindable key slot of the active key profile.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @return
+ *      One entry per mapping and slot (First, Second, ...).
+ *      Empty until the first local player's Enhanced Input
+ *      user settings exist.
+ *
+ * @usage (Blueprint)
+ *      GetInputBindings(Self)
+ *      → ForEachLoop
+ *      → Create row widget (MappingName, Key)
+ */
+TArray<FBindingData> UGeneralSettingsBFL::GetInputBindings(const UObject* WorldContextObject)
+{
+	if (UInputSettingsSubsystem* Sub = GetInputSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->GetBindings();
+	}
+	return {};
+}
+
+/**
+ * Checks whether a key is already used by another slot.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param Binding
+ *      Slot and the key the player pressed.
+ *
+ * @param Conflict
+ *      Filled with the slot currently using that key.
+ *
+ * @return
+ *      True if another slot already uses the key.
+ *
+ * @usage (Blueprint)
+ *      OnKeySelected (InputKeySelector)
+ *      → FindInputConflict
+ *      → Branch → show "Replace binding?" prompt
+ */
+bool UGeneralSettingsBFL::FindInputConflict(const UObject* WorldContextObject, const FBindingData& Binding, FBindingData& Conflict)
+{
+	if (UInputSettingsSubsystem* Sub = GetInputSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->FindConflict(Binding, Conflict);
+	}
+	return false;
+}
+
+/**
+ * Binds a key to one slot and saves the input profile.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param Binding
+ *      Mapping name, slot and new key.
+ *
+ * @param bClearConflicts
+ *      If true, a slot already using the key is unbound.
+ *      If false, the rebind is refused instead.
+ *
+ * @return
+ *      True if the key was bound.
+ *
+ * @note
+ *      Applied immediately; no SaveSettings() call is needed.
+ */
+bool UGeneralSettingsBFL::RebindInputKey(const UObject* WorldContextObject, const FBindingData& Binding, bool bClearConflicts)
+{
+	if (UInputSettingsSubsystem* Sub = GetInputSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->RebindKey(Binding, bClearConflicts);
+	}
+	return false;
+}
+
+/**
+ * Binds several keys at once with a single mapping rebuild and save.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ *
+ * @param Bindings
+ *      Slots to rebind, applied in order.
+ *
+ * @param bClearConflicts
+ *      Same as RebindInputKey.
+ *
+ * @return
+ *      Number of slots bound.
+ *
+ * @usage (Blueprint)
+ *      Apply button on the controls page
+ *      → RebindInputKeys(Self, ChangedBindings)
+ */
+int32 UGeneralSettingsBFL::RebindInputKeys(const UObject* WorldContextObject, const TArray<FBindingData>& Bindings, bool bClearConflicts)
+{
+	if (UInputSettingsSubsystem* Sub = GetInputSettingsSubsystem(WorldContextObject))
+	{
+		return Sub->RebindKeys(Bindings, bClearConflicts);
+	}
+	return 0;
+}
+
+/**
+ * Restores every key slot to its default and saves the input profile.
+ *
+ * @param WorldContextObject
+ *      Any UObject that provides a valid world context.
+ */
+void UGeneralSettingsBFL::ResetInputBindings(const UObject* WorldContextObject)
+{
+	if (UInputSettingsSubsystem* Sub = GetInputSettingsSubsystem(WorldContextObject))
+	{
+		Sub->ResetBindings();
+	}
+}
+
 FUserSettingsData UGeneralSettingsBFL::GetDefaultSettingsData(const UObject* WorldContextObject)
 {
 	if (USettingsSubsystem* Sub = GetSettingsSubsystem(WorldContextObject))
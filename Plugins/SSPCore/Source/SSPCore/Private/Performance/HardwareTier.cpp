@@ -0,0 +1,142 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Performance/HardwareTier.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMisc.h"
+#include "Misc/FileHelper.h"
+#include "Performance/MemoryBudget.h"
+#include "RHI.h"
+#include "Subsystems/SettingsSubsystem.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#endif
+
+namespace
+{
+	constexpr int64 BytesPerMB = 1024 * 1024;
+
+	int32 GetCpuClockMHz()
+	{
+#if PLATFORM_WINDOWS
+		DWORD MHz = 0;
+		DWORD Size = sizeof(MHz);
+		if (::RegGetValueW(HKEY_LOCAL_MACHINE, TEXT("HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0"),
+			TEXT("~MHz"), RRF_RT_REG_DWORD, nullptr, &MHz, &Size) == ERROR_SUCCESS)
+		{
+			return static_cast<int32>(MHz);
+		}
+#elif PLATFORM_LINUX
+		FString KHz;
+		if (FFileHelper::LoadFileToString(KHz, TEXT("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq")))
+		{
+			return static_cast<int32>(FCString::Atoi64(*KHz) / 1000);
+		}
+#endif
+		return 0;
+	}
+}
+
+bool FHardwareTierProfile::IsMetBy(const FHardwareDescription& Hardware) const
+{
+	auto Meets = [](int32 Value, int32 Minimum)
+	{
+		return Minimum <= 0 || (Value > 0 && Value >= Minimum);
+	};
+	// Memory is compared in whole GB rounded to nearest, since "16 GB" machines report a little less
+	return Meets(Hardware.NumCores, MinCores)
+		&& Meets(Hardware.CpuClockMHz, MinCpuClockMHz)
+		&& Meets((Hardware.MemoryMB + 512) / 1024, MinMemoryGB)
+		&& Meets((Hardware.VideoMemoryMB + 512) / 1024, MinVideoMemoryGB)
+		&& (bAllowIntegratedGPU || !Hardware.bIntegratedGPU);
+}
+
+FHardwareDescription HardwareTier::Describe()
+{
+	FHardwareDescription Hardware;
+	Hardware.NumCores = FPlatformMisc::NumberOfCores();
+	Hardware.NumLogicalCores = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+	Hardware.CpuClockMHz = GetCpuClockMHz();
+	Hardware.MemoryMB = static_cast<int32>(FPlatformMemory::GetConstants().TotalPhysical / BytesPerMB);
+	Hardware.VideoMemoryMB = static_cast<int32>(MemoryBudget::GetVideoMemoryBytes() / BytesPerMB);
+	if (GDynamicRHI && !GUsingNullRHI)
+	{
+		Hardware.bHasRHI = true;
+		Hardware.bIntegratedGPU = GRHIDeviceIsIntegrated;
+		Hardware.GPUVendorId = static_cast<int32>(GRHIVendorId);
+		Hardware.AdapterName = GRHIAdapterName;
+	}
+	return Hardware;
+}
+
+int32 HardwareTier::Classify(const FHardwareDescription& Hardware, TConstArrayView<FHardwareTierProfile> Profiles)
+{
+	int32 Best = INDEX_NONE;
+	int32 Lowest = INDEX_NONE;
+	for (int32 i = 0; i < Profiles.Num(); ++i)
+	{
+		if (Lowest == INDEX_NONE || Profiles[i].Tier < Profiles[Lowest].Tier)
+		{
+			Lowest = i;
+		}
+		if (Profiles[i].IsMetBy(Hardware) && (Best == INDEX_NONE || Profiles[i].Tier > Profiles[Best].Tier))
+		{
+			Best = i;
+		}
+	}
+	return Best != INDEX_NONE ? Best : Lowest;
+}
+
+const TArray<FHardwareTierProfile>& HardwareTier::GetBuiltInProfiles()
+{
+	auto Make = [](EHardwareTier Tier, int32 Cores, int32 ClockMHz, int32 MemoryGB, int32 VideoMemoryGB, bool bIntegrated, int32 Quality)
+	{
+		FHardwareTierProfile Profile;
+		Profile.Tier = Tier;
+		Profile.MinCores = Cores;
+		Profile.MinCpuClockMHz = ClockMHz;
+		Profile.MinMemoryGB = MemoryGB;
+		Profile.MinVideoMemoryGB = VideoMemoryGB;
+		Profile.bAllowIntegratedGPU = bIntegrated;
+		Profile.GraphicsQuality = Quality;
+		return Profile;
+	};
+	static const TArray<FHardwareTierProfile> Profiles = {
+		Make(EHardwareTier::Low, 0, 0, 0, 0, true, 0),
+		Make(EHardwareTier::Medium, 4, 2000, 8, 2, true, 1),
+		Make(EHardwareTier::High, 6, 2500, 16, 6, false, 2),
+		Make(EHardwareTier::Epic, 8, 3000, 32, 10, false, 3),
+	};
+	return Profiles;
+}
+
+static FAutoConsoleCommandWithArgsAndOutputDevice SSPHardwareTierCommand(
+	TEXT("ssp.HardwareTier"),
+	TEXT("Classifies this machine against the tier table. Cores=, ClockMHz=, MemoryGB=, VideoMemoryGB= and Integrated= ")
+	TEXT("replace the detected values, e.g. ssp.HardwareTier MemoryGB=8 Integrated=1"),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, FOutputDevice& Ar)
+	{
+		FHardwareDescription Hardware = HardwareTier::Describe();
+		const FString Cmd = FString::Join(Args, TEXT(" "));
+		int32 GB = 0;
+		FParse::Value(*Cmd, TEXT("Cores="), Hardware.NumCores);
+		FParse::Value(*Cmd, TEXT("ClockMHz="), Hardware.CpuClockMHz);
+		if (FParse::Value(*Cmd, TEXT("MemoryGB="), GB))
+		{
+			Hardware.MemoryMB = GB * 1024;
+		}
+		if (FParse::Value(*Cmd, TEXT("VideoMemoryGB="), GB))
+		{
+			Hardware.VideoMemoryMB = GB * 1024;
+		}
+		FParse::Bool(*Cmd, TEXT("Integrated="), Hardware.bIntegratedGPU);
+
+		const TArray<FHardwareTierProfile>& Profiles = GetDefault<USettingsSubsystem>()->GetHardwareTierProfiles();
+		const int32 Index = HardwareTier::Classify(Hardware, Profiles);
+		Ar.Logf(TEXT("%d cores (%d logical), %d MHz, %d MB RAM, %d MB VRAM%s, \"%s\""),
+			Hardware.NumCores, Hardware.NumLogicalCores, Hardware.CpuClockMHz, Hardware.MemoryMB,
+			Hardware.VideoMemoryMB, Hardware.bIntegratedGPU ? TEXT(" (integrated)") : TEXT(""), *Hardware.AdapterName);
+		Ar.Logf(TEXT("Tier: %s"), Profiles.IsValidIndex(Index) ? *UEnum::GetDisplayValueAsText(Profiles[Index].Tier).ToString() : TEXT("none"));
+	}));
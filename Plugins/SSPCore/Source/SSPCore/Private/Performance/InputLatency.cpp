@@ -0,0 +1,405 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Performance/InputLatency.h"
+
+#if SSP_WITH_INPUT_LATENCY
+
+#include "EnhancedInputComponent.h"
+#include "Framework/Application/IInputProcessor.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/IConsoleManager.h"
+#include "InputMappingContext.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Rendering/SlateRenderer.h"
+
+static TAutoConsoleVariable<bool> CVarSSPInputLatencyEnable(
+	TEXT("ssp.InputLatency.Enable"),
+	false,
+	TEXT("Timestamp probed input actions from raw input to present. See ssp.InputLatency.Report."));
+
+static constexpr int32 MaxInFlightSamples = 1024;
+
+static const TCHAR* GetStageName(int32 Stage)
+{
+	switch (static_cast<EInputLatencyStage>(Stage))
+	{
+	case EInputLatencyStage::RawToTrigger:		return TEXT("raw_to_trigger");
+	case EInputLatencyStage::TriggerToConsume:	return TEXT("trigger_to_consume");
+	case EInputLatencyStage::ConsumeToPresent:	return TEXT("consume_to_present");
+	case EInputLatencyStage::RawToPresent:		return TEXT("raw_to_present");
+	default: return TEXT("unknown");
+	}
+}
+
+void FLatencyHistogram::Add(double Microseconds)
+{
+	int32 Bucket = 0;
+	if (Microseconds > 50.0)
+	{
+		Bucket = FMath::Min(NumBuckets - 1, FMath::CeilToInt32(FMath::Loge(Microseconds / 50.0) / FMath::Loge(1.25)));
+	}
+	Buckets[Bucket].fetch_add(1, std::memory_order_relaxed);
+	Count.fetch_add(1, std::memory_order_relaxed);
+}
+
+double FLatencyHistogram::Percentile(double P) const
+{
+	const uint32 Total = GetCount();
+	if (Total == 0)
+	{
+		return 0.0;
+	}
+	const uint64 Rank = FMath::Max<uint64>(1, static_cast<uint64>(FMath::CeilToDouble(P * Total)));
+	uint64 Seen = 0;
+	for (int32 i = 0; i < NumBuckets; ++i)
+	{
+		Seen += Buckets[i].load(std::memory_order_relaxed);
+		if (Seen >= Rank)
+		{
+			return BucketUpperUs(i);
+		}
+	}
+	return BucketUpperUs(NumBuckets - 1);
+}
+
+void FLatencyHistogram::Reset()
+{
+	for (std::atomic<uint32>& Bucket : Buckets)
+	{
+		Bucket.store(0, std::memory_order_relaxed);
+	}
+	Count.store(0, std::memory_order_relaxed);
+}
+
+double FLatencyHistogram::BucketUpperUs(int32 Bucket)
+{
+	return 50.0 * FMath::Pow(1.25, static_cast<double>(Bucket));
+}
+
+class FLatencyInputProcessor : public IInputProcessor
+{
+public:
+	virtual void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override {}
+
+	virtual bool HandleKeyDownEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent) override
+	{
+		if (!InKeyEvent.IsRepeat())
+		{
+			FInputLatencyTracker::Get().OnRawInput(InKeyEvent.GetKey());
+		}
+		return false;
+	}
+
+	virtual bool HandleMouseButtonDownEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override
+	{
+		FInputLatencyTracker::Get().OnRawInput(MouseEvent.GetEffectingButton());
+		return false;
+	}
+
+	// Sticks and triggers
+	virtual bool HandleAnalogInputEvent(FSlateApplication& SlateApp, const FAnalogInputEvent& InAnalogInputEvent) override
+	{
+		FInputLatencyTracker::Get().OnRawInput(InAnalogInputEvent.GetKey());
+		return false;
+	}
+
+	virtual bool HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override
+	{
+		// Mappings use either the 2D axis or the separate ones
+		FInputLatencyTracker& Tracker = FInputLatencyTracker::Get();
+		Tracker.OnRawInput(EKeys::Mouse2D);
+		Tracker.OnRawInput(EKeys::MouseX);
+		Tracker.OnRawInput(EKeys::MouseY);
+		return false;
+	}
+
+	virtual bool HandleMouseWheelOrGestureEvent(FSlateApplication& SlateApp, const FPointerEvent& InWheelEvent, const FPointerEvent* InGestureEvent) override
+	{
+		FInputLatencyTracker::Get().OnRawInput(EKeys::MouseWheelAxis);
+		return false;
+	}
+
+	virtual const TCHAR* GetDebugName() const override { return TEXT("SSPInputLatency"); }
+};
+
+FInputLatencyTracker& FInputLatencyTracker::Get()
+{
+	static FInputLatencyTracker Tracker;
+	return Tracker;
+}
+
+bool FInputLatencyTracker::IsEnabled()
+{
+	return CVarSSPInputLatencyEnable.GetValueOnAnyThread();
+}
+
+void FInputLatencyTracker::Startup()
+{
+	if (!FSlateApplication::IsInitialized() || InputProcessor.IsValid())
+	{
+		return;
+	}
+	InputProcessor = MakeShared<FLatencyInputProcessor>();
+	FSlateApplication::Get().RegisterInputPreProcessor(InputProcessor);
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FInputLatencyTracker::OnEndFrame);
+	if (FSlateRenderer* Renderer = FSlateApplication::Get().GetRenderer())
+	{
+		PresentHandle = Renderer->OnBackBufferReadyToPresent().AddLambda([this](SWindow&, const FTextureRHIRef&)
+		{
+			OnPresent();
+		});
+	}
+}
+
+void FInputLatencyTracker::Shutdown()
+{
+	if (FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().UnregisterInputPreProcessor(InputProcessor);
+		if (FSlateRenderer* Renderer = FSlateApplication::Get().GetRenderer())
+		{
+			Renderer->OnBackBufferReadyToPresent().Remove(PresentHandle);
+		}
+	}
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	InputProcessor.Reset();
+	EndFrameHandle.Reset();
+	PresentHandle.Reset();
+}
+
+FInputLatencyTracker::FActionLatency& FInputLatencyTracker::FindOrAddAction(const UInputAction* Action)
+{
+	if (const int32* Index = ActionToIndex.Find(Action))
+	{
+		return *Actions[*Index];
+	}
+	FActionLatency& Latency = *Actions.Add_GetRef(MakeUnique<FActionLatency>());
+	Latency.Name = Action->GetFName();
+	ActionToIndex.Add(Action, Actions.Num() - 1);
+	return Latency;
+}
+
+void FInputLatencyTracker::BindProbes(UEnhancedInputComponent* InputComponent, const UInputMappingContext* Context)
+{
+	if (!InputComponent || !Context)
+	{
+		return;
+	}
+	TSet<const UInputAction*> Bound;
+	BindProbes(InputComponent, Context->GetMappings(), Bound);
+}
+
+void FInputLatencyTracker::BindProbes(UEnhancedInputComponent* InputComponent, TConstArrayView<FEnhancedActionKeyMapping> Mappings, TSet<const UInputAction*>& Bound)
+{
+	if (!InputComponent)
+	{
+		return;
+	}
+	for (const FEnhancedActionKeyMapping& Mapping : Mappings)
+	{
+		const UInputAction* Action = Mapping.Action;
+		if (!Action)
+		{
+			continue;
+		}
+		FActionLatency& Latency = FindOrAddAction(Action);
+		Latency.Keys.AddUnique(Mapping.Key);
+		if (!Bound.Contains(Action))
+		{
+			Bound.Add(Action);
+			InputComponent->BindActionValueLambda(Action, ETriggerEvent::Started, [this, &Latency](const FInputActionValue&)
+			{
+				OnTriggered(Latency);
+			});
+		}
+	}
+}
+
+void FInputLatencyTracker::OnRawInput(const FKey& Key)
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+	LastRawInput.Add(Key, FPlatformTime::Cycles64());
+}
+
+void FInputLatencyTracker::OnTriggered(FActionLatency& Action)
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+	const uint64 Now = FPlatformTime::Cycles64();
+	uint64 Raw = 0;
+	for (const FKey& Key : Action.Keys)
+	{
+		if (const uint64* Time = LastRawInput.Find(Key))
+		{
+			Raw = FMath::Max(Raw, *Time);
+		}
+	}
+	const uint64 PreviousTrigger = Action.LastTrigger;
+	Action.LastTrigger = Now;
+	if (Raw == 0 || Raw <= PreviousTrigger)
+	{
+		// Triggered from code, by input already counted, or by a key rebound after the probes
+		// were bound. Timing it against some other key would skew the histograms.
+		++Action.NumUnmatched;
+		return;
+	}
+
+	Action.PendingRaw = Raw;
+	Action.PendingTrigger = Now;
+	Action.PendingConsume = 0;
+	if (!Action.bPending)
+	{
+		Action.bPending = true;
+		PendingActions.Add(&Action);
+	}
+}
+
+void FInputLatencyTracker::MarkConsumed(const UInputAction* Action)
+{
+	const int32* Index = ActionToIndex.Find(Action);
+	if (!Index || !IsEnabled())
+	{
+		return;
+	}
+	FActionLatency& Latency = *Actions[*Index];
+	if (Latency.bPending && Latency.PendingConsume == 0)
+	{
+		Latency.PendingConsume = FPlatformTime::Cycles64();
+	}
+}
+
+void FInputLatencyTracker::OnEndFrame()
+{
+	for (FActionLatency* Action : PendingActions)
+	{
+		Action->bPending = false;
+		if (NumInFlight.load(std::memory_order_relaxed) >= MaxInFlightSamples)
+		{
+			continue;
+		}
+		FInFlightSample Sample;
+		Sample.Action = Action;
+		Sample.Raw = Action->PendingRaw;
+		Sample.Trigger = Action->PendingTrigger;
+		// Actions nobody reports on count as handled when they trigger
+		Sample.Consume = Action->PendingConsume ? Action->PendingConsume : Action->PendingTrigger;
+		Sample.Frame = GFrameCounter;
+		InFlight.Enqueue(Sample);
+		NumInFlight.fetch_add(1, std::memory_order_relaxed);
+	}
+	PendingActions.Reset();
+}
+
+void FInputLatencyTracker::OnPresent()
+{
+	const uint64 Now = FPlatformTime::Cycles64();
+	const uint64 PresentedFrame = GFrameCounterRenderThread;
+	auto ToUs = [](uint64 From, uint64 To)
+	{
+		return FPlatformTime::ToMilliseconds64(To > From ? To - From : 0) * 1000.0;
+	};
+
+	FInFlightSample Sample;
+	while (InFlight.Peek(Sample) && Sample.Frame <= PresentedFrame)
+	{
+		InFlight.Pop();
+		NumInFlight.fetch_sub(1, std::memory_order_relaxed);
+		FLatencyHistogram* Stages = Sample.Action->Stages;
+		Stages[static_cast<int32>(EInputLatencyStage::RawToTrigger)].Add(ToUs(Sample.Raw, Sample.Trigger));
+		Stages[static_cast<int32>(EInputLatencyStage::TriggerToConsume)].Add(ToUs(Sample.Trigger, Sample.Consume));
+		Stages[static_cast<int32>(EInputLatencyStage::ConsumeToPresent)].Add(ToUs(Sample.Consume, Now));
+		Stages[static_cast<int32>(EInputLatencyStage::RawToPresent)].Add(ToUs(Sample.Raw, Now));
+	}
+}
+
+void FInputLatencyTracker::Report(FOutputDevice& Ar) const
+{
+	if (Actions.Num() == 0)
+	{
+		Ar.Logf(TEXT("SSPInputLatency no probed actions; call FInputLatencyTracker::BindProbes"));
+		return;
+	}
+	for (const TUniquePtr<FActionLatency>& Action : Actions)
+	{
+		Ar.Logf(TEXT("SSPInputLatency action=%s unmatched=%u"), *Action->Name.ToString(), Action->NumUnmatched);
+		for (int32 Stage = 0; Stage < static_cast<int32>(EInputLatencyStage::Num); ++Stage)
+		{
+			const FLatencyHistogram& Histogram = Action->Stages[Stage];
+			Ar.Logf(TEXT("SSPInputLatency action=%s stage=%s count=%u p50_us=%.0f p95_us=%.0f p99_us=%.0f"),
+				*Action->Name.ToString(), GetStageName(Stage), Histogram.GetCount(),
+				Histogram.Percentile(0.50), Histogram.Percentile(0.95), Histogram.Percentile(0.99));
+		}
+	}
+}
+
+bool FInputLatencyTracker::WriteCSV(const FString& Path) const
+{
+	FString CSV = TEXT("Action,Stage,Count,P50Us,P95Us,P99Us\n");
+	for (const TUniquePtr<FActionLatency>& Action : Actions)
+	{
+		for (int32 Stage = 0; Stage < static_cast<int32>(EInputLatencyStage::Num); ++Stage)
+		{
+			const FLatencyHistogram& Histogram = Action->Stages[Stage];
+			CSV += FString::Printf(TEXT("%s,%s,%u,%.0f,%.0f,%.0f\n"),
+				*Action->Name.ToString(), GetStageName(Stage), Histogram.GetCount(),
+				Histogram.Percentile(0.50), Histogram.Percentile(0.95), Histogram.Percentile(0.99));
+		}
+	}
+	return FFileHelper::SaveStringToFile(CSV, *Path);
+}
+
+void FInputLatencyTracker::Reset()
+{
+	for (const TUniquePtr<FActionLatency>& Action : Actions)
+	{
+		Action->NumUnmatched = 0;
+		for (FLatencyHistogram& Histogram : Action->Stages)
+		{
+			Histogram.Reset();
+		}
+	}
+}
+
+static FDelayedAutoRegisterHelper GSSPInputLatencyStartup(EDelayedRegisterRunPhase::EndOfEngineInit, []
+{
+	FInputLatencyTracker::Get().Startup();
+	FCoreDelegates::OnPreExit.AddLambda([] { FInputLatencyTracker::Get().Shutdown(); });
+});
+
+static FAutoConsoleCommandWithOutputDevice SSPInputLatencyReportCommand(
+	TEXT("ssp.InputLatency.Report"),
+	TEXT("Prints p50/p95/p99 input latency per probed action and stage, in microseconds."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		FInputLatencyTracker::Get().Report(Ar);
+	}));
+
+static FAutoConsoleCommandWithArgsAndOutputDevice SSPInputLatencyDumpCommand(
+	TEXT("ssp.InputLatency.DumpCSV"),
+	TEXT("Writes the input latency percentiles to a CSV. Optional argument: file path (default Saved/Profiling)."),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, FOutputDevice& Ar)
+	{
+		const FString Path = Args.Num() > 0 ? Args[0]
+			: FPaths::ProfilingDir() / FString::Printf(TEXT("SSPInputLatency-%s.csv"), *FDateTime::Now().ToString());
+		const bool bWritten = FInputLatencyTracker::Get().WriteCSV(Path);
+		Ar.Logf(TEXT("SSPInputLatency csv=%s written=%d"), *Path, bWritten ? 1 : 0);
+	}));
+
+static FAutoConsoleCommand SSPInputLatencyResetCommand(
+	TEXT("ssp.InputLatency.Reset"),
+	TEXT("Clears the input latency histograms."),
+	FConsoleCommandDelegate::CreateLambda([]
+	{
+		FInputLatencyTracker::Get().Reset();
+	}));
+
+#endif
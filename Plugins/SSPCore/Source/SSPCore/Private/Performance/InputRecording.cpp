@@ -0,0 +1,175 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Performance/InputRecording.h"
+
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+static constexpr uint32 InputRecordingMagic = 0x43455259; // "YREC"
+static constexpr uint32 InputRecordingVersion = 1;
+
+void FInputRecording::Reset()
+{
+	NumFrames = 0;
+	Keys.Reset();
+	Events.Reset();
+}
+
+uint16 FInputRecording::FindOrAddKey(const FKey& Key)
+{
+	const int32 Index = Keys.AddUnique(Key);
+	check(Index <= MAX_uint16);
+	return static_cast<uint16>(Index);
+}
+
+void FInputRecording::Add(uint32 Frame, ERecordedInputType Type, const FKey& Key, float X, float Y)
+{
+	FRecordedInputEvent& Event = Events.AddDefaulted_GetRef();
+	Event.Frame = Frame;
+	Event.Type = Type;
+	Event.Key = (Type == ERecordedInputType::MouseMove || Type == ERecordedInputType::MouseWheel) ? 0 : FindOrAddKey(Key);
+	Event.X = X;
+	Event.Y = Y;
+	NumFrames = FMath::Max(NumFrames, Frame + 1);
+}
+
+void FInputRecording::Serialize(TArray<uint8>& OutBytes) const
+{
+	FMemoryWriter Writer(OutBytes);
+	uint32 Magic = InputRecordingMagic;
+	uint32 Version = InputRecordingVersion;
+	float DeltaTime = FixedDeltaTime;
+	int32 SeedValue = Seed;
+	uint32 Frames = NumFrames;
+	int32 NumKeys = Keys.Num();
+	uint32 NumEvents = Events.Num();
+	Writer << Magic << Version << DeltaTime << SeedValue << Frames << NumKeys;
+	for (const FKey& Key : Keys)
+	{
+		FString KeyName = Key.GetFName().ToString();
+		Writer << KeyName;
+	}
+
+	Writer.SerializeIntPacked(NumEvents);
+	uint32 PreviousFrame = 0;
+	for (const FRecordedInputEvent& Event : Events)
+	{
+		uint32 FrameDelta = Event.Frame - PreviousFrame;
+		uint8 Type = static_cast<uint8>(Event.Type);
+		Writer.SerializeIntPacked(FrameDelta);
+		Writer << Type;
+		switch (Event.Type)
+		{
+		case ERecordedInputType::KeyDown:
+		case ERecordedInputType::KeyUp:
+		{
+			uint32 Key = Event.Key;
+			Writer.SerializeIntPacked(Key);
+			break;
+		}
+		case ERecordedInputType::Analog:
+		{
+			uint32 Key = Event.Key;
+			float X = Event.X;
+			Writer.SerializeIntPacked(Key);
+			Writer << X;
+			break;
+		}
+		case ERecordedInputType::MouseMove:
+		{
+			float X = Event.X, Y = Event.Y;
+			Writer << X << Y;
+			break;
+		}
+		case ERecordedInputType::MouseWheel:
+		{
+			float X = Event.X;
+			Writer << X;
+			break;
+		}
+		}
+		PreviousFrame = Event.Frame;
+	}
+}
+
+bool FInputRecording::Deserialize(const TArray<uint8>& Bytes)
+{
+	Reset();
+	FMemoryReader Reader(Bytes);
+	uint32 Magic = 0, Version = 0;
+	int32 NumKeys = 0;
+	Reader << Magic << Version << FixedDeltaTime << Seed << NumFrames << NumKeys;
+	if (Reader.IsError() || Magic != InputRecordingMagic || Version > InputRecordingVersion
+		|| NumKeys < 0 || NumKeys > MAX_uint16 || FixedDeltaTime <= 0.f)
+	{
+		return false;
+	}
+	Keys.Reserve(NumKeys);
+	for (int32 i = 0; i < NumKeys && !Reader.IsError(); ++i)
+	{
+		FString KeyName;
+		Reader << KeyName;
+		Keys.Add(FKey(FName(*KeyName)));
+	}
+
+	uint32 NumEvents = 0;
+	Reader.SerializeIntPacked(NumEvents);
+	if (Reader.IsError() || NumEvents > static_cast<uint32>(Bytes.Num()))
+	{
+		return false;
+	}
+	Events.Reserve(NumEvents);
+	uint32 Frame = 0;
+	for (uint32 i = 0; i < NumEvents && !Reader.IsError(); ++i)
+	{
+		uint32 FrameDelta = 0, Key = 0;
+		uint8 Type = 0;
+		Reader.SerializeIntPacked(FrameDelta);
+		Reader << Type;
+		Frame += FrameDelta;
+
+		FRecordedInputEvent& Event = Events.AddDefaulted_GetRef();
+		Event.Frame = Frame;
+		Event.Type = static_cast<ERecordedInputType>(Type);
+		switch (Event.Type)
+		{
+		case ERecordedInputType::KeyDown:
+		case ERecordedInputType::KeyUp:
+			Reader.SerializeIntPacked(Key);
+			break;
+		case ERecordedInputType::Analog:
+			Reader.SerializeIntPacked(Key);
+			Reader << Event.X;
+			break;
+		case ERecordedInputType::MouseMove:
+			Reader << Event.X << Event.Y;
+			break;
+		case ERecordedInputType::MouseWheel:
+			Reader << Event.X;
+			break;
+		default:
+			return false;
+		}
+		if (Key >= static_cast<uint32>(FMath::Max(Keys.Num(), 1)))
+		{
+			return false;
+		}
+		Event.Key = static_cast<uint16>(Key);
+	}
+	return !Reader.IsError();
+}
+
+bool FInputRecording::SaveToFile(const FString& Path) const
+{
+	TArray<uint8> Bytes;
+	Serialize(Bytes);
+	return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool FInputRecording::LoadFromFile(const FString& Path)
+{
+	TArray<uint8> Bytes;
+	return FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent) && Deserialize(Bytes);
+}
@@ -0,0 +1,71 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Performance/MemoryBudget.h"
+
+#include "ContentStreaming.h"
+#include "RHI.h"
+
+namespace
+{
+	constexpr int64 BytesPerMB = 1024 * 1024;
+	// Pools are handed out in steps so the recommendation does not move every sample
+	constexpr int32 PoolStepMB = 128;
+	constexpr int32 MinPoolMB = 400;
+
+	int32 RoundUpToStep(int64 MB)
+	{
+		return static_cast<int32>(FMath::DivideAndRoundUp<int64>(FMath::Max<int64>(MB, 0), PoolStepMB) * PoolStepMB);
+	}
+}
+
+int32 MemoryBudget::GetTexturePoolLimitMB(uint64 PhysicalBytes, uint64 VideoBytes)
+{
+	// A quarter of RAM leaves room for the game and the OS; 70% of VRAM for render targets
+	int64 LimitMB = static_cast<int64>(PhysicalBytes / 4) / BytesPerMB;
+	if (VideoBytes > 0)
+	{
+		LimitMB = FMath::Min<int64>(LimitMB, static_cast<int64>(VideoBytes * 7 / 10) / BytesPerMB);
+	}
+	return FMath::Max(MinPoolMB, static_cast<int32>(LimitMB / PoolStepMB * PoolStepMB));
+}
+
+int32 MemoryBudget::GetDefaultTexturePoolMB(uint64 PhysicalBytes, uint64 VideoBytes)
+{
+	const uint64 PhysicalGB = (PhysicalBytes + BytesPerMB * 512) / (BytesPerMB * 1024);
+	const int32 TierMB = PhysicalGB <= 8 ? 768 : PhysicalGB <= 16 ? 1536 : PhysicalGB <= 32 ? 2560 : 3584;
+	return FMath::Min(TierMB, GetTexturePoolLimitMB(PhysicalBytes, VideoBytes));
+}
+
+uint64 MemoryBudget::GetVideoMemoryBytes()
+{
+	if (!GDynamicRHI)
+	{
+		return 0;
+	}
+	FTextureMemoryStats Stats;
+	RHIGetTextureMemoryStats(Stats);
+	return Stats.DedicatedVideoMemory > 0 ? static_cast<uint64>(Stats.DedicatedVideoMemory) : 0;
+}
+
+FSettingsMemoryPressure MemoryBudget::Sample(int32 LimitMB)
+{
+	FSettingsMemoryPressure Pressure;
+	if (!IStreamingManager::Get().IsTextureStreamingEnabled())
+	{
+		return Pressure;
+	}
+	const ITextureStreamingManager& Streaming = IStreamingManager::Get().GetTextureStreamingManager();
+	Pressure.PoolSizeMB = static_cast<int32>(Streaming.GetPoolSize() / BytesPerMB);
+	Pressure.OverBudgetMB = static_cast<int32>(FMath::Max<int64>(Streaming.GetMemoryOverBudget(), 0) / BytesPerMB);
+	Pressure.MaxEverRequiredMB = static_cast<int32>(Streaming.GetMaxEverRequired() / BytesPerMB);
+	Pressure.bOverBudget = Pressure.OverBudgetMB > 0;
+	if (Pressure.bOverBudget)
+	{
+		// Cover the peak demand with 10% headroom
+		const int32 WantedMB = RoundUpToStep(FMath::Max(Pressure.PoolSizeMB + Pressure.OverBudgetMB, Pressure.MaxEverRequiredMB) * 11 / 10);
+		Pressure.RecommendedPoolSizeMB = FMath::Min(WantedMB, LimitMB);
+		Pressure.bAtMemoryLimit = WantedMB > LimitMB;
+	}
+	return Pressure;
+}
@@ -0,0 +1,108 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Performance/QualityGovernor.h"
+
+const EScalabilityGroup FQualityGovernor::StepDownOrder[ScalabilityGroup::Num] =
+{
+	EScalabilityGroup::Shadows,
+	EScalabilityGroup::GlobalIllumination,
+	EScalabilityGroup::Reflections,
+	EScalabilityGroup::PostProcess,
+	EScalabilityGroup::Effects,
+	EScalabilityGroup::Foliage,
+	EScalabilityGroup::ViewDistance,
+	EScalabilityGroup::Shading,
+	EScalabilityGroup::AntiAliasing,
+	EScalabilityGroup::Textures,
+};
+
+FQualityGovernor::FQualityGovernor(const FQualityGovernorConfig& InConfig)
+	: Config(InConfig)
+{
+	FLevels Zero;
+	for (int32& Level : Zero)
+	{
+		Level = 0;
+	}
+	Reset(Zero);
+}
+
+void FQualityGovernor::Reset(const FLevels& UserLevels)
+{
+	Levels = UserLevels;
+	Ceiling = UserLevels;
+	GameSum = 0.0;
+	BoundSum = 0.0;
+	WindowCount = 0;
+	SettleRemaining = 0;
+}
+
+FQualityGovernorDecision FQualityGovernor::AddSample(const FFrameTimeSample& Sample)
+{
+	FQualityGovernorDecision Decision;
+
+	if (SettleRemaining > 0)
+	{
+		--SettleRemaining;
+		return Decision;
+	}
+
+	GameSum += Sample.GameMs;
+	BoundSum += FMath::Max3(Sample.GameMs, Sample.RenderMs, Sample.GPUMs);
+	if (++WindowCount < FMath::Max(Config.WindowFrames, 1))
+	{
+		return Decision;
+	}
+
+	const float GameAvg = static_cast<float>(GameSum / WindowCount);
+	const float BoundAvg = static_cast<float>(BoundSum / WindowCount);
+	GameSum = 0.0;
+	BoundSum = 0.0;
+	WindowCount = 0;
+	Decision.AverageMs = BoundAvg;
+
+	if (BoundAvg > Config.TargetFrameMs * Config.DownRatio)
+	{
+		// Render/GPU cost is what the groups control; a game-thread bottleneck stays as is
+		if (GameAvg >= BoundAvg)
+		{
+			return Decision;
+		}
+
+		for (const EScalabilityGroup Group : StepDownOrder)
+		{
+			int32& Level = Levels[static_cast<int32>(Group)];
+			if (Level > 0)
+			{
+				--Level;
+				Decision.Action = EQualityGovernorAction::StepDown;
+				Decision.Group = Group;
+				Decision.NewLevel = Level;
+				break;
+			}
+		}
+	}
+	else if (BoundAvg < Config.TargetFrameMs * Config.UpRatio)
+	{
+		for (int32 i = ScalabilityGroup::Num - 1; i >= 0; --i)
+		{
+			const int32 GroupIndex = static_cast<int32>(StepDownOrder[i]);
+			int32& Level = Levels[GroupIndex];
+			if (Level < Ceiling[GroupIndex])
+			{
+				++Level;
+				Decision.Action = EQualityGovernorAction::StepUp;
+				Decision.Group = StepDownOrder[i];
+				Decision.NewLevel = Level;
+				break;
+			}
+		}
+	}
+
+	if (Decision.Action != EQualityGovernorAction::None)
+	{
+		SettleRemaining = Config.SettleFrames;
+	}
+	return Decision;
+}
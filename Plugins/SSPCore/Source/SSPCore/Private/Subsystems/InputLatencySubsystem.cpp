@@ -0,0 +1,58 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/InputLatencySubsystem.h"
+
+#include "Engine/LocalPlayer.h"
+#include "EnhancedInputComponent.h"
+#include "EnhancedInputSubsystems.h"
+#include "EnhancedPlayerInput.h"
+#include "GameFramework/PlayerController.h"
+#include "Performance/InputLatency.h"
+
+bool UInputLatencySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return SSP_WITH_INPUT_LATENCY && !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UInputLatencySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UEnhancedInputLocalPlayerSubsystem* EnhancedInput = Collection.InitializeDependency<UEnhancedInputLocalPlayerSubsystem>())
+	{
+		EnhancedInput->ControlMappingsRebuiltDelegate.AddDynamic(this, &UInputLatencySubsystem::HandleControlMappingsRebuilt);
+	}
+}
+
+void UInputLatencySubsystem::Deinitialize()
+{
+	if (UEnhancedInputLocalPlayerSubsystem* EnhancedInput = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(GetLocalPlayer()))
+	{
+		EnhancedInput->ControlMappingsRebuiltDelegate.RemoveDynamic(this, &UInputLatencySubsystem::HandleControlMappingsRebuilt);
+	}
+	ProbedComponent.Reset();
+	ProbedActions.Reset();
+	Super::Deinitialize();
+}
+
+void UInputLatencySubsystem::HandleControlMappingsRebuilt()
+{
+#if SSP_WITH_INPUT_LATENCY
+	const ULocalPlayer* Player = GetLocalPlayer();
+	const APlayerController* PlayerController = Player ? Player->GetPlayerController(nullptr) : nullptr;
+	UEnhancedInputComponent* Input = PlayerController ? Cast<UEnhancedInputComponent>(PlayerController->InputComponent) : nullptr;
+	const UEnhancedInputLocalPlayerSubsystem* EnhancedInput = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(Player);
+	const UEnhancedPlayerInput* PlayerInput = EnhancedInput ? EnhancedInput->GetPlayerInput() : nullptr;
+	if (!Input || !PlayerInput)
+	{
+		return;
+	}
+	if (ProbedComponent.Get() != Input)
+	{
+		ProbedComponent = Input;
+		ProbedActions.Reset();
+	}
+	FInputLatencyTracker::Get().BindProbes(Input, PlayerInput->GetEnhancedActionMappings(), ProbedActions);
+#endif
+}
@@ -0,0 +1,363 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/InputReplaySubsystem.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Framework/Application/IInputProcessor.h"
+#include "Framework/Application/SlateApplication.h"
+#include "GenericPlatform/GenericPlatformInputDeviceMapper.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+static TAutoConsoleVariable<float> CVarSSPInputReplayFPS(
+	TEXT("ssp.InputReplay.FPS"),
+	60.f,
+	TEXT("Fixed frame rate used while recording input; playback uses the rate stored in the file."));
+
+class FInputReplayProcessor : public IInputProcessor
+{
+public:
+	explicit FInputReplayProcessor(UInputReplaySubsystem* InOwner) : Owner(InOwner) {}
+
+	virtual void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override {}
+
+	virtual bool HandleKeyDownEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent) override
+	{
+		// Repeats come from the OS; only state changes are recorded
+		if (InKeyEvent.IsRepeat())
+		{
+			return Owner.IsValid() && Owner->IsBlockingRealInput();
+		}
+		return Handle(ERecordedInputType::KeyDown, InKeyEvent.GetKey());
+	}
+
+	virtual bool HandleKeyUpEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent) override
+	{
+		return Handle(ERecordedInputType::KeyUp, InKeyEvent.GetKey());
+	}
+
+	virtual bool HandleAnalogInputEvent(FSlateApplication& SlateApp, const FAnalogInputEvent& InAnalogInputEvent) override
+	{
+		return Handle(ERecordedInputType::Analog, InAnalogInputEvent.GetKey(), InAnalogInputEvent.GetAnalogValue());
+	}
+
+	virtual bool HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override
+	{
+		const FVector2D Delta = MouseEvent.GetCursorDelta();
+		if (Delta.IsZero())
+		{
+			return false;
+		}
+		return Handle(ERecordedInputType::MouseMove, EKeys::Invalid, Delta.X, Delta.Y);
+	}
+
+	virtual bool HandleMouseButtonDownEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override
+	{
+		return Handle(ERecordedInputType::KeyDown, MouseEvent.GetEffectingButton());
+	}
+
+	virtual bool HandleMouseButtonUpEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override
+	{
+		return Handle(ERecordedInputType::KeyUp, MouseEvent.GetEffectingButton());
+	}
+
+	virtual bool HandleMouseWheelOrGestureEvent(FSlateApplication& SlateApp, const FPointerEvent& InWheelEvent, const FPointerEvent* InGestureEvent) override
+	{
+		return Handle(ERecordedInputType::MouseWheel, EKeys::Invalid, InWheelEvent.GetWheelDelta());
+	}
+
+	virtual const TCHAR* GetDebugName() const override { return TEXT("SSPInputReplay"); }
+
+private:
+	bool Handle(ERecordedInputType Type, const FKey& Key, float X = 0.f, float Y = 0.f)
+	{
+		return Owner.IsValid() && Owner->HandleRawInput(Type, Key, X, Y);
+	}
+
+	TWeakObjectPtr<UInputReplaySubsystem> Owner;
+};
+
+bool UInputReplaySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UInputReplaySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	if (FParse::Value(CommandLine, TEXT("SSPInputRecord="), RecordingPath) || FParse::Value(CommandLine, TEXT("SSPInputPlayback="), RecordingPath))
+	{
+		bExitWhenFinished = FParse::Param(CommandLine, TEXT("SSPInputPlaybackExit"));
+		PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UInputReplaySubsystem::HandlePostLoadMap);
+	}
+}
+
+void UInputReplaySubsystem::Deinitialize()
+{
+	Stop();
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	Super::Deinitialize();
+}
+
+FString UInputReplaySubsystem::ResolvePath(const FString& Path)
+{
+	return FPaths::IsRelative(Path) ? FPaths::ProjectSavedDir() / TEXT("InputRecordings") / Path : Path;
+}
+
+void UInputReplaySubsystem::HandlePostLoadMap(UWorld* World)
+{
+	// Only the first map: later travel must not restart the session
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	PostLoadMapHandle.Reset();
+
+	FString Path;
+	if (FParse::Value(FCommandLine::Get(), TEXT("SSPInputRecord="), Path))
+	{
+		StartRecording(Path);
+	}
+	else if (FParse::Value(FCommandLine::Get(), TEXT("SSPInputPlayback="), Path) && !StartPlayback(Path) && bExitWhenFinished)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, 1);
+	}
+}
+
+bool UInputReplaySubsystem::StartRecording(const FString& Path)
+{
+	if (Mode != EMode::Idle || !FSlateApplication::IsInitialized())
+	{
+		return false;
+	}
+	Recording.Reset();
+	Recording.FixedDeltaTime = 1.f / FMath::Max(CVarSSPInputReplayFPS.GetValueOnGameThread(), 1.f);
+	Recording.Seed = FMath::Rand();
+	RecordingPath = ResolvePath(Path);
+	Begin(EMode::Recording);
+	UE_LOG(LogTemp, Log, TEXT("InputReplay: recording to %s"), *RecordingPath);
+	return true;
+}
+
+bool UInputReplaySubsystem::StartPlayback(const FString& Path)
+{
+	if (Mode != EMode::Idle || !FSlateApplication::IsInitialized())
+	{
+		return false;
+	}
+	RecordingPath = ResolvePath(Path);
+	if (!Recording.LoadFromFile(RecordingPath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("InputReplay: could not read %s"), *RecordingPath);
+		return false;
+	}
+	Begin(EMode::Playing);
+	// Real focus may be anywhere, e.g. nowhere at all under -nullrhi
+	FSlateApplication::Get().SetAllUserFocusToGameViewport();
+	UE_LOG(LogTemp, Log, TEXT("InputReplay: playing %s (%u frames, %d events)"), *RecordingPath, Recording.NumFrames, Recording.Events.Num());
+	return true;
+}
+
+void UInputReplaySubsystem::Begin(EMode NewMode)
+{
+	Mode = NewMode;
+	Frame = 0;
+	NextEvent = 0;
+	HeldKeys.Reset();
+
+	bSavedFixedTimeStep = FApp::UseFixedTimeStep();
+	SavedFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(Recording.FixedDeltaTime);
+	FMath::RandInit(Recording.Seed);
+	FMath::SRandInit(Recording.Seed);
+
+	InputProcessor = MakeShared<FInputReplayProcessor>(this);
+	// First in line, so recorded input is what the game actually saw and real input is dropped during playback
+	FSlateApplication::Get().RegisterInputPreProcessor(InputProcessor, 0);
+	BeginFrameHandle = FCoreDelegates::OnBeginFrame.AddUObject(this, &UInputReplaySubsystem::OnBeginFrame);
+}
+
+void UInputReplaySubsystem::Stop()
+{
+	if (Mode == EMode::Idle)
+	{
+		return;
+	}
+	if (Mode == EMode::Recording)
+	{
+		Recording.NumFrames = FMath::Max(Recording.NumFrames, Frame + 1);
+		const bool bSaved = Recording.SaveToFile(RecordingPath);
+		UE_LOG(LogTemp, Log, TEXT("InputReplay: %s %s (%u frames, %d events)"),
+			bSaved ? TEXT("saved") : TEXT("failed to save"), *RecordingPath, Recording.NumFrames, Recording.Events.Num());
+	}
+	else
+	{
+		// Release anything still held so the game is not left running forward
+		for (const uint16 Key : HeldKeys.Array())
+		{
+			FRecordedInputEvent Release;
+			Release.Type = ERecordedInputType::KeyUp;
+			Release.Key = Key;
+			Inject(Release);
+		}
+	}
+
+	Mode = EMode::Idle;
+	HeldKeys.Reset();
+	FCoreDelegates::OnBeginFrame.Remove(BeginFrameHandle);
+	BeginFrameHandle.Reset();
+	if (FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().UnregisterInputPreProcessor(InputProcessor);
+	}
+	InputProcessor.Reset();
+	FApp::SetUseFixedTimeStep(bSavedFixedTimeStep);
+	FApp::SetFixedDeltaTime(SavedFixedDeltaTime);
+}
+
+void UInputReplaySubsystem::OnBeginFrame()
+{
+	++Frame;
+	if (Mode != EMode::Playing)
+	{
+		return;
+	}
+
+	// Events are stamped with the frame whose message pump received them, which runs right after this
+	const TArray<FRecordedInputEvent>& Events = Recording.Events;
+	while (NextEvent < Events.Num() && Events[NextEvent].Frame <= Frame)
+	{
+		Inject(Events[NextEvent++]);
+	}
+
+	if (Frame >= Recording.NumFrames)
+	{
+		UE_LOG(LogTemp, Log, TEXT("InputReplay: finished %s after %u frames"), *RecordingPath, Frame);
+		Stop();
+		OnPlaybackFinished.Broadcast();
+		if (bExitWhenFinished)
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+}
+
+bool UInputReplaySubsystem::HandleRawInput(ERecordedInputType Type, const FKey& Key, float X, float Y)
+{
+	if (Mode == EMode::Recording)
+	{
+		Recording.Add(Frame, Type, Key, X, Y);
+		return false;
+	}
+	return IsBlockingRealInput();
+}
+
+void UInputReplaySubsystem::Inject(const FRecordedInputEvent& Event)
+{
+	FSlateApplication& Slate = FSlateApplication::Get();
+	const FKey Key = Recording.Keys.IsValidIndex(Event.Key) ? Recording.Keys[Event.Key] : EKeys::Invalid;
+	const FInputDeviceId Device = IPlatformInputDeviceMapper::Get().GetDefaultInputDevice();
+	const FModifierKeysState Modifiers = Slate.GetModifierKeys();
+	const FVector2D Cursor = Slate.GetCursorPos();
+
+	TGuardValue<bool> Injecting(bInjecting, true);
+	switch (Event.Type)
+	{
+	case ERecordedInputType::KeyDown:
+	case ERecordedInputType::KeyUp:
+	{
+		const bool bDown = Event.Type == ERecordedInputType::KeyDown;
+		if (bDown)
+		{
+			HeldKeys.Add(Event.Key);
+		}
+		else
+		{
+			HeldKeys.Remove(Event.Key);
+		}
+
+		if (Key.IsMouseButton())
+		{
+			TSet<FKey> Pressed;
+			if (bDown)
+			{
+				Pressed.Add(Key);
+			}
+			const FPointerEvent MouseEvent(0, 0, Cursor, Cursor, Pressed, Key, 0.f, Modifiers);
+			if (bDown)
+			{
+				Slate.ProcessMouseButtonDownEvent(nullptr, MouseEvent);
+			}
+			else
+			{
+				Slate.ProcessMouseButtonUpEvent(MouseEvent);
+			}
+		}
+		else
+		{
+			const FKeyEvent KeyEvent(Key, Modifiers, Device, false, 0, 0);
+			if (bDown)
+			{
+				Slate.ProcessKeyDownEvent(KeyEvent);
+			}
+			else
+			{
+				Slate.ProcessKeyUpEvent(KeyEvent);
+			}
+		}
+		break;
+	}
+	case ERecordedInputType::Analog:
+		Slate.ProcessAnalogInputEvent(FAnalogInputEvent(Key, Modifiers, Device, false, 0, 0, Event.X));
+		break;
+	case ERecordedInputType::MouseMove:
+		Slate.ProcessMouseMoveEvent(FPointerEvent(0, 0, Cursor + FVector2D(Event.X, Event.Y), Cursor, TSet<FKey>(), EKeys::Invalid, 0.f, Modifiers));
+		break;
+	case ERecordedInputType::MouseWheel:
+		Slate.ProcessMouseWheelOrGestureEvent(FPointerEvent(0, 0, Cursor, Cursor, TSet<FKey>(), EKeys::Invalid, Event.X, Modifiers), nullptr);
+		break;
+	}
+}
+
+static UInputReplaySubsystem* GetInputReplaySubsystem(UWorld* World)
+{
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UInputReplaySubsystem>() : nullptr;
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice SSPInputReplayRecordCommand(
+	TEXT("ssp.InputReplay.Record"),
+	TEXT("ssp.InputReplay.Record <File>: records raw input at ssp.InputReplay.FPS until ssp.InputReplay.Stop."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		UInputReplaySubsystem* Replay = GetInputReplaySubsystem(World);
+		const bool bStarted = Replay && Args.Num() > 0 && Replay->StartRecording(Args[0]);
+		Ar.Logf(TEXT("InputReplay record started=%d"), bStarted ? 1 : 0);
+	}));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice SSPInputReplayPlayCommand(
+	TEXT("ssp.InputReplay.Play"),
+	TEXT("ssp.InputReplay.Play <File>: plays a recording back at its fixed timestep, ignoring real input."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		UInputReplaySubsystem* Replay = GetInputReplaySubsystem(World);
+		const bool bStarted = Replay && Args.Num() > 0 && Replay->StartPlayback(Args[0]);
+		Ar.Logf(TEXT("InputReplay play started=%d"), bStarted ? 1 : 0);
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs SSPInputReplayStopCommand(
+	TEXT("ssp.InputReplay.Stop"),
+	TEXT("Stops input recording (saving the file) or playback."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>&, UWorld* World)
+	{
+		if (UInputReplaySubsystem* Replay = GetInputReplaySubsystem(World))
+		{
+			Replay->Stop();
+		}
+	}));
@@ -2,3 +2,375 @@
 
 
 #include "Subsystems/InputSettingsSubsystem.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/LocalPlayer.h"
+#include "EnhancedInputSubsystems.h"
+#include "GameplayTagContainer.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+static const TCHAR* InputProfileName = TEXT("YenumInputProfile");
+static constexpr uint32 InputProfileMagic = 0x504E4959; // "YINP"
+
+void FInputKeyIndex::Add(const FBindingData& Binding)
+{
+	const FSlotId Slot(Binding.MappingName, Binding.Slot);
+	RemoveSlot(Slot);
+	if (const FBindingData* Holder = ByKey.Find(Binding.Key))
+	{
+		BySlot.Remove(FSlotId(Holder->MappingName, Holder->Slot));
+	}
+	ByKey.Add(Binding.Key, Binding);
+	BySlot.Add(Slot, Binding.Key);
+}
+
+void FInputKeyIndex::RemoveSlot(const FSlotId& Slot)
+{
+	FKey Key;
+	if (BySlot.RemoveAndCopyValue(Slot, Key))
+	{
+		ByKey.Remove(Key);
+	}
+}
+
+void FInputKeyIndex::Reset()
+{
+	ByKey.Reset();
+	BySlot.Reset();
+}
+
+bool UInputSettingsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UInputSettingsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LocalPlayerAddedHandle = GetGameInstance()->OnLocalPlayerAddedEvent.AddUObject(this, &UInputSettingsSubsystem::HandleLocalPlayerAdded);
+
+	Persistence = MakeUnique<FSettingsPersistence>(
+		FPaths::ProjectSavedDir() / TEXT("SaveGames") / FString(InputProfileName) + TEXT(".settings"));
+	Persistence->LoadAsync([WeakThis = TWeakObjectPtr<UInputSettingsSubsystem>(this)](TArray<uint8>&& Bytes)
+	{
+		if (UInputSettingsSubsystem* Self = WeakThis.Get())
+		{
+			Self->HandleProfileLoaded(MoveTemp(Bytes));
+		}
+	});
+}
+
+void UInputSettingsSubsystem::Deinitialize()
+{
+	if (UGameInstance* GameInstance = GetGameInstance())
+	{
+		GameInstance->OnLocalPlayerAddedEvent.Remove(LocalPlayerAddedHandle);
+	}
+	LocalPlayerAddedHandle.Reset();
+	if (Persistence)
+	{
+		Persistence->Flush();
+	}
+
+	Super::Deinitialize();
+}
+
+UEnhancedInputLocalPlayerSubsystem* UInputSettingsSubsystem::GetInputSubsystem() const
+{
+	const ULocalPlayer* LocalPlayer = GetGameInstance() ? GetGameInstance()->GetFirstGamePlayer() : nullptr;
+	return LocalPlayer ? LocalPlayer->GetSubsystem<UEnhancedInputLocalPlayerSubsystem>() : nullptr;
+}
+
+UEnhancedInputUserSettings* UInputSettingsSubsystem::GetUserSettings() const
+{
+	const UEnhancedInputLocalPlayerSubsystem* InputSubsystem = GetInputSubsystem();
+	return InputSubsystem ? InputSubsystem->GetUserSettings() : nullptr;
+}
+
+void UInputSettingsSubsystem::HandleProfileLoaded(TArray<uint8>&& Bytes)
+{
+	TArray<FBindingData> Bindings;
+	if (Bytes.Num() > 0 && !DeserializeProfile(Bytes, Bindings))
+	{
+		// A partly read profile could bind half a layout; start from the defaults instead
+		UE_LOG(LogTemp, Warning, TEXT("InputSettingsSubsystem: input profile is unreadable, using defaults"));
+		Bindings.Reset();
+	}
+	for (const FBindingData& Binding : Bindings)
+	{
+		// Rebinds made while loading win over the file
+		Overrides.FindOrAdd(FSlotId(Binding.MappingName, Binding.Slot), Binding);
+	}
+	bProfileLoaded = true;
+	ApplyProfile();
+}
+
+void UInputSettingsSubsystem::HandleLocalPlayerAdded(ULocalPlayer* LocalPlayer)
+{
+	ApplyProfile();
+}
+
+void UInputSettingsSubsystem::ApplyProfile()
+{
+	if (bProfileApplied || !bProfileLoaded)
+	{
+		return;
+	}
+	UEnhancedInputLocalPlayerSubsystem* InputSubsystem = GetInputSubsystem();
+	UEnhancedInputUserSettings* Settings = InputSubsystem ? InputSubsystem->GetUserSettings() : nullptr;
+	if (!Settings)
+	{
+		// Retried when a local player is added
+		return;
+	}
+	bProfileApplied = true;
+
+	for (const TPair<FSlotId, FBindingData>& Override : Overrides)
+	{
+		FMapPlayerKeyArgs Args;
+		Args.MappingName = Override.Value.MappingName;
+		Args.Slot = Override.Value.Slot;
+		Args.NewKey = Override.Value.Key;
+		Args.bDeferOnSettingsChangedBroadcast = true;
+		FGameplayTagContainer FailureReason;
+		// An invalid key is a slot that was cleared by a conflict
+		if (Args.NewKey.IsValid())
+		{
+			Settings->MapPlayerKey(Args, FailureReason);
+		}
+		else
+		{
+			Settings->UnMapPlayerKey(Args, FailureReason);
+		}
+		if (!FailureReason.IsEmpty())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("InputSettingsSubsystem: could not restore %s: %s"),
+				*Args.MappingName.ToString(), *FailureReason.ToStringSimple());
+		}
+	}
+	if (Overrides.Num() > 0)
+	{
+		Settings->ApplySettings();
+		InputSubsystem->RequestRebuildControlMappings();
+	}
+	RebuildIndex();
+	OnInputBindingsChanged.Broadcast();
+}
+
+TArray<FBindingData> UInputSettingsSubsystem::GetBindings() const
+{
+	TArray<FBindingData> Bindings;
+	const UEnhancedInputUserSettings* Settings = GetUserSettings();
+	const UEnhancedPlayerMappableKeyProfile* Profile = Settings ? Settings->GetActiveKeyProfile() : nullptr;
+	if (!Profile)
+	{
+		return Bindings;
+	}
+	for (const TPair<FName, FKeyMappingRow>& Row : Profile->GetPlayerMappingRows())
+	{
+		for (const FPlayerKeyMapping& Mapping : Row.Value.Mappings)
+		{
+			const FSlotId SlotId(Mapping.GetMappingName(), Mapping.GetSlot());
+			if (const FBindingData* Override = Overrides.Find(SlotId))
+			{
+				Bindings.Add(*Override);
+				continue;
+			}
+			FBindingData& Binding = Bindings.AddDefaulted_GetRef();
+			Binding.MappingName = Mapping.GetMappingName();
+			Binding.Slot = Mapping.GetSlot();
+			Binding.Key = Mapping.GetCurrentKey();
+		}
+	}
+	return Bindings;
+}
+
+void UInputSettingsSubsystem::RebuildIndex()
+{
+	KeyIndex.Reset();
+	for (const FBindingData& Binding : GetBindings())
+	{
+		if (Binding.Key.IsValid())
+		{
+			KeyIndex.Add(Binding);
+		}
+	}
+}
+
+bool UInputSettingsSubsystem::FindConflict(const FBindingData& Binding, FBindingData& OutConflict) const
+{
+	const FBindingData* Bound = KeyIndex.FindByKey(Binding.Key);
+	if (!Bound || (Bound->MappingName == Binding.MappingName && Bound->Slot == Binding.Slot))
+	{
+		return false;
+	}
+	OutConflict = *Bound;
+	return true;
+}
+
+int32 UInputSettingsSubsystem::RebindKeys(TConstArrayView<FBindingData> Bindings, bool bClearConflicts)
+{
+	UEnhancedInputLocalPlayerSubsystem* InputSubsystem = GetInputSubsystem();
+	UEnhancedInputUserSettings* Settings = InputSubsystem ? InputSubsystem->GetUserSettings() : nullptr;
+	if (!Settings)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("RebindKeys: Enhanced Input user settings are unavailable"));
+		return 0;
+	}
+	ApplyProfile();
+
+	const int32 NumBound = ResolveRebinds(Bindings, bClearConflicts, KeyIndex, Overrides, [Settings](const FBindingData& Binding)
+	{
+		FMapPlayerKeyArgs Args;
+		Args.MappingName = Binding.MappingName;
+		Args.Slot = Binding.Slot;
+		Args.NewKey = Binding.Key;
+		Args.bDeferOnSettingsChangedBroadcast = true;
+		FGameplayTagContainer FailureReason;
+		if (Binding.Key.IsValid())
+		{
+			Settings->MapPlayerKey(Args, FailureReason);
+		}
+		else
+		{
+			Settings->UnMapPlayerKey(Args, FailureReason);
+		}
+		if (!FailureReason.IsEmpty())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("RebindKeys: %s: %s"), *Binding.MappingName.ToString(), *FailureReason.ToStringSimple());
+			return false;
+		}
+		return true;
+	});
+
+	if (NumBound > 0)
+	{
+		// One rebuild for the whole batch
+		Settings->ApplySettings();
+		InputSubsystem->RequestRebuildControlMappings();
+		RebuildIndex();
+		SaveProfile();
+		OnInputBindingsChanged.Broadcast();
+	}
+	return NumBound;
+}
+
+int32 UInputSettingsSubsystem::ResolveRebinds(TConstArrayView<FBindingData> Bindings, bool bClearConflicts, FInputKeyIndex& Index,
+	TMap<FSlotId, FBindingData>& Overrides, TFunctionRef<bool(const FBindingData&)> MapKey)
+{
+	int32 NumBound = 0;
+	for (const FBindingData& Binding : Bindings)
+	{
+		const FBindingData* Bound = Index.FindByKey(Binding.Key);
+		if (Bound && (Bound->MappingName != Binding.MappingName || Bound->Slot != Binding.Slot))
+		{
+			if (!bClearConflicts)
+			{
+				continue;
+			}
+			FBindingData Cleared = *Bound;
+			Cleared.Key = EKeys::Invalid;
+			MapKey(Cleared);
+			const FSlotId ClearedSlot(Cleared.MappingName, Cleared.Slot);
+			Index.RemoveSlot(ClearedSlot);
+			Overrides.Add(ClearedSlot, Cleared);
+		}
+
+		if (!MapKey(Binding))
+		{
+			continue;
+		}
+		// Keep the index in step so later entries in the batch see this one
+		Index.Add(Binding);
+		Overrides.Add(FSlotId(Binding.MappingName, Binding.Slot), Binding);
+		++NumBound;
+	}
+	return NumBound;
+}
+
+void UInputSettingsSubsystem::ResetBindings()
+{
+	UEnhancedInputLocalPlayerSubsystem* InputSubsystem = GetInputSubsystem();
+	if (UEnhancedInputUserSettings* Settings = InputSubsystem ? InputSubsystem->GetUserSettings() : nullptr)
+	{
+		TSet<FName> Rows;
+		for (const TPair<FSlotId, FBindingData>& Override : Overrides)
+		{
+			Rows.Add(Override.Key.Key);
+		}
+		for (const FName Row : Rows)
+		{
+			FMapPlayerKeyArgs Args;
+			Args.MappingName = Row;
+			Args.bDeferOnSettingsChangedBroadcast = true;
+			FGameplayTagContainer FailureReason;
+			Settings->ResetAllPlayerKeysInRow(Args, FailureReason);
+		}
+		Settings->ApplySettings();
+		InputSubsystem->RequestRebuildControlMappings();
+	}
+	Overrides.Reset();
+	RebuildIndex();
+	SaveProfile();
+	OnInputBindingsChanged.Broadcast();
+}
+
+void UInputSettingsSubsystem::SaveProfile()
+{
+	TArray<FBindingData> Bindings;
+	Overrides.GenerateValueArray(Bindings);
+	TArray<uint8> Bytes;
+	SerializeProfile(Bindings, Bytes);
+	Persistence->Write(MoveTemp(Bytes));
+}
+
+void UInputSettingsSubsystem::SerializeProfile(const TArray<FBindingData>& Bindings, TArray<uint8>& OutBytes)
+{
+	// Per slot: mapping name, slot and key name. Names are stored as strings
+	// so the file does not depend on the name table.
+	FMemoryWriter Writer(OutBytes);
+	uint32 Magic = InputProfileMagic;
+	uint32 Version = ProfileVersion;
+	int32 Num = Bindings.Num();
+	Writer << Magic << Version << Num;
+	for (const FBindingData& Binding : Bindings)
+	{
+		FString MappingName = Binding.MappingName.ToString();
+		uint8 Slot = static_cast<uint8>(Binding.Slot);
+		FString KeyName = Binding.Key.GetFName().ToString();
+		Writer << MappingName << Slot << KeyName;
+	}
+}
+
+bool UInputSettingsSubsystem::DeserializeProfile(const TArray<uint8>& Bytes, TArray<FBindingData>& OutBindings)
+{
+	FMemoryReader Reader(Bytes);
+	uint32 Magic = 0, Version = 0;
+	int32 Num = 0;
+	Reader << Magic << Version << Num;
+	if (Reader.IsError() || Magic != InputProfileMagic || Version > ProfileVersion || Num < 0 || Num > Bytes.Num())
+	{
+		return false;
+	}
+	OutBindings.Reset(Num);
+	for (int32 i = 0; i < Num && !Reader.IsError(); ++i)
+	{
+		FString MappingName, KeyName;
+		uint8 Slot = 0;
+		Reader << MappingName << Slot << KeyName;
+		if (Version < 2)
+		{
+			// Modifier bits, never applied to Enhanced Input
+			uint8 Modifiers = 0;
+			Reader << Modifiers;
+		}
+		FBindingData& Binding = OutBindings.AddDefaulted_GetRef();
+		Binding.MappingName = FName(*MappingName);
+		Binding.Slot = static_cast<EPlayerMappableKeySlot>(Slot);
+		Binding.Key = FKey(FName(*KeyName));
+	}
+	return !Reader.IsError();
+}
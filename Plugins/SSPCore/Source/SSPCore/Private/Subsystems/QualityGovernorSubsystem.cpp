@@ -0,0 +1,168 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/QualityGovernorSubsystem.h"
+
+#include "Data/SettingsSaveGame.h"
+#include "DynamicRHI.h"
+#include "RenderCore.h"
+#include "Scalability.h"
+#include "Subsystems/SettingsSubsystem.h"
+
+static TAutoConsoleVariable<bool> CVarSSPGovernorEnable(
+	TEXT("ssp.Governor.Enable"),
+	false,
+	TEXT("Let the quality governor step scalability groups to hold ssp.Governor.TargetFPS."));
+
+static TAutoConsoleVariable<float> CVarSSPGovernorTargetFPS(
+	TEXT("ssp.Governor.TargetFPS"),
+	60.f,
+	TEXT("Frame rate the quality governor tries to hold."));
+
+bool UQualityGovernorSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Nothing is rendered on a dedicated server
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UQualityGovernorSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (USettingsSubsystem* Settings = Collection.InitializeDependency<USettingsSubsystem>())
+	{
+		Settings->OnSettingsApplied.AddDynamic(this, &UQualityGovernorSubsystem::HandleSettingsApplied);
+	}
+}
+
+void UQualityGovernorSubsystem::Deinitialize()
+{
+	if (bGoverning)
+	{
+		StopGoverning();
+	}
+	if (USettingsSubsystem* Settings = GetGameInstance()->GetSubsystem<USettingsSubsystem>())
+	{
+		Settings->OnSettingsApplied.RemoveDynamic(this, &UQualityGovernorSubsystem::HandleSettingsApplied);
+	}
+	Super::Deinitialize();
+}
+
+void UQualityGovernorSubsystem::Tick(float DeltaTime)
+{
+	if (!CVarSSPGovernorEnable.GetValueOnGameThread())
+	{
+		StopGoverning();
+		return;
+	}
+	if (!bGoverning)
+	{
+		StartGoverning();
+	}
+
+	FQualityGovernorConfig Config;
+	Config.TargetFrameMs = 1000.f / FMath::Max(CVarSSPGovernorTargetFPS.GetValueOnGameThread(), 1.f);
+	Governor.SetConfig(Config);
+
+	FFrameTimeSample Sample;
+	Sample.GameMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	Sample.RenderMs = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+	Sample.GPUMs = FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles());
+
+	const FQualityGovernorDecision Decision = Governor.AddSample(Sample);
+	if (Decision.Action == EQualityGovernorAction::None)
+	{
+		return;
+	}
+
+	PushLevels(Governor.GetLevels());
+	UE_LOG(LogTemp, Log, TEXT("QualityGovernor: %s %s to %d (avg %.2f ms, target %.2f ms)"),
+		Decision.Action == EQualityGovernorAction::StepDown ? TEXT("lowered") : TEXT("raised"),
+		*UEnum::GetDisplayValueAsText(Decision.Group).ToString(),
+		Decision.NewLevel, Decision.AverageMs, Config.TargetFrameMs);
+}
+
+ETickableTickType UQualityGovernorSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UQualityGovernorSubsystem::IsTickable() const
+{
+	// Keep ticking for one frame after the CVar is cleared so the user's levels are restored
+	return bGoverning || CVarSSPGovernorEnable.GetValueOnGameThread();
+}
+
+TStatId UQualityGovernorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UQualityGovernorSubsystem, STATGROUP_Tickables);
+}
+
+void UQualityGovernorSubsystem::HandleSettingsApplied(USettingsSaveGame* AppliedSettings)
+{
+	if (!bGoverning)
+	{
+		return;
+	}
+	// New ceiling: start again from what the player just chose
+	const FQualityGovernor::FLevels UserLevels = GetUserLevels(AppliedSettings ? &AppliedSettings->Data : GetUserSettings());
+	Governor.Reset(UserLevels);
+	PushLevels(UserLevels);
+	UE_LOG(LogTemp, Log, TEXT("QualityGovernor: settings applied, ceiling reset"));
+}
+
+void UQualityGovernorSubsystem::StartGoverning()
+{
+	Governor.Reset(GetUserLevels(GetUserSettings()));
+	bGoverning = true;
+	UE_LOG(LogTemp, Log, TEXT("QualityGovernor: enabled"));
+}
+
+void UQualityGovernorSubsystem::StopGoverning()
+{
+	if (!bGoverning)
+	{
+		return;
+	}
+	PushLevels(Governor.GetCeiling());
+	bGoverning = false;
+	UE_LOG(LogTemp, Log, TEXT("QualityGovernor: disabled, user levels restored"));
+}
+
+const FUserSettingsData* UQualityGovernorSubsystem::GetUserSettings() const
+{
+	const USettingsSubsystem* Settings = GetGameInstance()->GetSubsystem<USettingsSubsystem>();
+	return Settings && Settings->IsSettingsReady() && Settings->GetSaveGame() ? &Settings->GetSaveGame()->Data : nullptr;
+}
+
+FQualityGovernor::FLevels UQualityGovernorSubsystem::GetUserLevels(const FUserSettingsData* UserSettings)
+{
+	FQualityGovernor::FLevels Levels;
+	if (UserSettings)
+	{
+		// Merging with nothing resolves groups that still follow the overall level
+		const FUserSettingsData Resolved = UserSettings->MergedWith(FPendingSettings());
+		for (int32 i = 0; i < ScalabilityGroup::Num; ++i)
+		{
+			Levels[i] = ScalabilityGroup::Level(Resolved, static_cast<EScalabilityGroup>(i));
+		}
+		return Levels;
+	}
+
+	const Scalability::FQualityLevels Quality = Scalability::GetQualityLevels();
+	for (int32 i = 0; i < ScalabilityGroup::Num; ++i)
+	{
+		Levels[i] = ScalabilityGroup::Level(Quality, static_cast<EScalabilityGroup>(i));
+	}
+	return Levels;
+}
+
+void UQualityGovernorSubsystem::PushLevels(const FQualityGovernor::FLevels& Levels) const
+{
+	Scalability::FQualityLevels Quality = Scalability::GetQualityLevels();
+	for (int32 i = 0; i < ScalabilityGroup::Num; ++i)
+	{
+		ScalabilityGroup::Level(Quality, static_cast<EScalabilityGroup>(i)) = Levels[i];
+	}
+	Scalability::SetQualityLevels(Quality);
+}
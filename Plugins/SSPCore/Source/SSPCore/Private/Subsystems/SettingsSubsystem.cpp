@@ -3,225 +3,1274 @@
 
 #include "Subsystems/SettingsSubsystem.h"
 
+#include "CVars/SettingsCVars.h"
+#include "AudioDevice.h"
 #include "Data/PendingSettings.h"
+#include "Data/SettingsPreset.h"
 #include "Data/SettingsSaveGame.h"
+#include "Data/SettingsSchema.h"
+#include "Engine/GameViewportClient.h"
+#include "Debug/SSPMemory.h"
+#include "Display/StartupDisplaySettings.h"
+#include "Engine/AssetManager.h"
+#include "Framework/Application/SlateApplication.h"
 #include "GameFramework/GameUserSettings.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Scalability.h"
 #include "Sound/SoundClass.h"
+#include "Widgets/SWindow.h"
 
-static const FName SoundMixName = TEXT("SoundMix");
-static const FName MasterSoundClassName = TEXT("Master");
-static const FName SFXSoundClassName = TEXT("SFX");
-static const FName DialogueSoundClassName = TEXT("Dialogue");
-static TArray<FIntPoint> CachedResolutions;
+static TAutoConsoleVariable<float> CVarSSPMemoryPollInterval(
+	TEXT("ssp.Memory.PollInterval"),
+	2.0f,
+	TEXT("Seconds between texture streaming pool pressure samples, 0 to stop sampling."));
+
+static TAutoConsoleVariable<float> CVarSSPAudioPreviewInterval(
+	TEXT("ssp.Audio.PreviewInterval"),
+	1.0f / 30.0f,
+	TEXT("Seconds between live mix updates while a volume slider is previewed."));
+
+static const TCHAR* SettingsSlotName = TEXT("YenumUserSettings");
+
+DECLARE_STATS_GROUP(TEXT("SSPCore"), STATGROUP_SSPCore, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Latency Mode"), STAT_SSPLatencyMode, STATGROUP_SSPCore);
+
+// Frame pipelining CVars driven by ELatencyMode, and their value per mode.
+// -1 is the engine / project value from before SSPCore first changed it.
+// D3D12.MaximumFrameLatency is only read when a swapchain is created, so the queued
+// frame limit follows on the next window mode change or restart; the rest are live.
+static const ESettingsCVar GLatencyModeCVars[] =
+{
+	ESettingsCVar::OneFrameThreadLag,
+	ESettingsCVar::GTSyncType,
+	ESettingsCVar::SyncSlackMS,
+	ESettingsCVar::MaxFrameLatency,
+};
+static const float GLatencyModeValues[][UE_ARRAY_COUNT(GLatencyModeCVars)] =
+{
+	// Off
+	{ -1.f, -1.f, -1.f, -1.f },
+	// On: render thread may still lag one frame, game thread syncs to the RHI thread
+	{ 1.f, 1.f, -1.f, 2.f },
+	// Boost: no lag, game thread starts as late before the flip as it can
+	{ 0.f, 2.f, 0.f, 1.f },
+};
+
+// Value CVar had before SSPCore first staged it, which "default" settings go back to
+static float GetCVarBaseline(ESettingsCVar CVar, const IConsoleVariable& Handle)
+{
+	static TOptional<float> Baselines[static_cast<int32>(ESettingsCVar::Num)];
+	TOptional<float>& Baseline = Baselines[static_cast<int32>(CVar)];
+	if (!Baseline.IsSet())
+	{
+		Baseline = Handle.GetFloat();
+	}
+	return Baseline.GetValue();
+}
+
+// Stages Value, or the baseline without one; skips CVars that are not registered
+static void StageOrRestoreCVar(FSettingsCVarTransaction& Transaction, ESettingsCVar CVar, float Value, bool bHasValue)
+{
+	if (const IConsoleVariable* Handle = SettingsCVars::Get(CVar))
+	{
+		const float Baseline = GetCVarBaseline(CVar, *Handle);
+		Transaction.Stage(CVar, bHasValue ? Value : Baseline);
+	}
+}
+
+static void StageLatencyMode(FSettingsCVarTransaction& Transaction, int32 Mode)
+{
+	const float* Values = GLatencyModeValues[FMath::Clamp(Mode, 0, static_cast<int32>(ELatencyMode::Boost))];
+	for (int32 i = 0; i < UE_ARRAY_COUNT(GLatencyModeCVars); ++i)
+	{
+		// The frame latency CVar only exists on RHIs that expose it (D3D12)
+		StageOrRestoreCVar(Transaction, GLatencyModeCVars[i], Values[i], Values[i] >= 0.f);
+	}
+}
+
+// Stages the CVar-backed fields of Target that are set in Fields
+static void StageSettingsCVars(FSettingsCVarTransaction& Transaction, const FUserSettingsData& Target, ESettingsField Fields)
+{
+	if (EnumHasAnyFlags(Fields, ESettingsField::Brightness))
+	{
+		Transaction.Stage(ESettingsCVar::ToneMapperGamma, FMath::Clamp(Target.Brightness, 0.5f, 3.0f));
+	}
+	// Not part of UGameUserSettings; persisted in our slot and re-applied from it
+	if (EnumHasAnyFlags(Fields, ESettingsField::DynResBudget))
+	{
+		Transaction.Stage(ESettingsCVar::DynResMinScreenPercentage, Target.DynResMinScreenPercentage);
+		Transaction.Stage(ESettingsCVar::DynResMaxScreenPercentage, Target.DynResMaxScreenPercentage);
+		Transaction.Stage(ESettingsCVar::DynResFrameTimeBudget, Target.DynResFrameTimeBudgetMs);
+	}
+	// Thread sync CVars switch on the next frame; the queued frame limit waits for a new swapchain
+	if (EnumHasAnyFlags(Fields, ESettingsField::LatencyMode))
+	{
+		StageLatencyMode(Transaction, Target.LatencyMode);
+	}
+	// The streamer re-reads its pool size every update
+	if (EnumHasAnyFlags(Fields, ESettingsField::MemoryBudgets))
+	{
+		StageOrRestoreCVar(Transaction, ESettingsCVar::StreamingPoolSize, static_cast<float>(Target.TexturePoolSizeMB), Target.TexturePoolSizeMB > 0);
+		StageOrRestoreCVar(Transaction, ESettingsCVar::StreamingPoolSizeForMeshes, static_cast<float>(Target.MeshPoolSizeMB), Target.MeshPoolSizeMB > 0);
+	}
+}
+
+// Fields whose CVars refused the staged value keep what the engine is actually running,
+// so the next apply sees them as dirty and tries again
+static void KeepUnappliedCVarFields(FUserSettingsData& Applied, const FUserSettingsData& Previous, const FSettingsCVarTransaction& Transaction)
+{
+	if (!Transaction.WasApplied(ESettingsCVar::ToneMapperGamma))
+	{
+		Applied.Brightness = Previous.Brightness;
+	}
+	if (!Transaction.WasApplied(ESettingsCVar::DynResMinScreenPercentage)
+		|| !Transaction.WasApplied(ESettingsCVar::DynResMaxScreenPercentage)
+		|| !Transaction.WasApplied(ESettingsCVar::DynResFrameTimeBudget))
+	{
+		Applied.DynResMinScreenPercentage = Previous.DynResMinScreenPercentage;
+		Applied.DynResMaxScreenPercentage = Previous.DynResMaxScreenPercentage;
+		Applied.DynResFrameTimeBudgetMs = Previous.DynResFrameTimeBudgetMs;
+	}
+	// MaxFrameLatency is left out, it only exists on D3D12
+	if (!Transaction.WasApplied(ESettingsCVar::OneFrameThreadLag)
+		|| !Transaction.WasApplied(ESettingsCVar::GTSyncType)
+		|| !Transaction.WasApplied(ESettingsCVar::SyncSlackMS))
+	{
+		Applied.LatencyMode = Previous.LatencyMode;
+	}
+	if (!Transaction.WasApplied(ESettingsCVar::StreamingPoolSize))
+	{
+		Applied.TexturePoolSizeMB = Previous.TexturePoolSizeMB;
+	}
+	if (!Transaction.WasApplied(ESettingsCVar::StreamingPoolSizeForMeshes))
+	{
+		Applied.MeshPoolSizeMB = Previous.MeshPoolSizeMB;
+	}
+}
+
+static void SetScalabilityGroupLevel(UGameUserSettings* GS, EScalabilityGroup Group, int32 Level)
+{
+	switch (Group)
+	{
+	case EScalabilityGroup::ViewDistance:		GS->SetViewDistanceQuality(Level); break;
+	case EScalabilityGroup::AntiAliasing:		GS->SetAntiAliasingQuality(Level); break;
+	case EScalabilityGroup::Shadows:			GS->SetShadowQuality(Level); break;
+	case EScalabilityGroup::GlobalIllumination:	GS->SetGlobalIlluminationQuality(Level); break;
+	case EScalabilityGroup::Reflections:		GS->SetReflectionQuality(Level); break;
+	case EScalabilityGroup::PostProcess:		GS->SetPostProcessingQuality(Level); break;
+	case EScalabilityGroup::Textures:			GS->SetTextureQuality(Level); break;
+	case EScalabilityGroup::Effects:			GS->SetVisualEffectQuality(Level); break;
+	case EScalabilityGroup::Foliage:			GS->SetFoliageQuality(Level); break;
+	case EScalabilityGroup::Shading:			GS->SetShadingQuality(Level); break;
+	default: break;
+	}
+}
+
+static EWindowMode::Type ToEngineWindowMode(int32 WindowMode)
+{
+	return WindowMode == 0 ? EWindowMode::Fullscreen :
+		WindowMode == 1 ? EWindowMode::WindowedFullscreen : EWindowMode::Windowed;
+}
+
+// The RHI creates the swapchain without a refresh rate and the driver runs the mode at its
+// highest, so a lower chosen rate in exclusive fullscreen is held by the frame rate limiter
+static float GetEngineFrameRateLimit(const FUserSettingsData& Data)
+{
+	if (Data.RefreshRate <= 0 || ToEngineWindowMode(Data.WindowMode) != EWindowMode::Fullscreen)
+	{
+		return Data.FrameRateLimit;
+	}
+	const float RefreshRate = static_cast<float>(Data.RefreshRate);
+	return Data.FrameRateLimit > 0.0f ? FMath::Min(Data.FrameRateLimit, RefreshRate) : RefreshRate;
+}
 
 void USettingsSubsystem::ApplySettings()
 {
+	if (!bSettingsReady)
+	{
+		// SaveGame still holds defaults; applying now would write them over the real slot
+		bApplyWhenReady = true;
+		return;
+	}
+
+	LLM_SCOPE_BYTAG(SSPCore_SettingsSubsystem);
 	auto* GS = GEngine->GetGameUserSettings();
-	if (PendingSettings.GraphicsQuality >= 0)
+
+	FUserSettingsData Target = SaveGame->Data.MergedWith(PendingSettings);
+	Target.ClampPerformanceFields();
+	const TConstArrayView<FIntPoint> Resolutions = DisplayModes.GetResolutions();
+	if (!Resolutions.IsValidIndex(Target.ResolutionIndex))
+	{
+		Target.ResolutionIndex = SaveGame->Data.ResolutionIndex;
+	}
+	// Borderless always runs at desktop resolution, keep the index in step with what the engine reports
+	if (ToEngineWindowMode(Target.WindowMode) == EWindowMode::WindowedFullscreen)
 	{
-		SaveGame->Data.GraphicsQuality = PendingSettings.GraphicsQuality;
-		GS->SetOverallScalabilityLevel(PendingSettings.GraphicsQuality);
+		const int32 CurrentIndex = DisplayModes.FindResolution(GS->GetScreenResolution());
+		if (CurrentIndex != INDEX_NONE)
+		{
+			Target.ResolutionIndex = CurrentIndex;
+		}
 	}
-	if (PendingSettings.Brightness >= 0)
+
+	if (Resolutions.IsValidIndex(Target.ResolutionIndex))
 	{
-		SaveGame->Data.Brightness = PendingSettings.Brightness;
-		float Gamma = FMath::Clamp(PendingSettings.Brightness, 0.5f, 3.0f);
+		Target.Resolution = Resolutions[Target.ResolutionIndex];
+	}
+
+	const ESettingsField EngineDirty = Target.Diff(AppliedSettings) & ~ESettingsField::Volumes;
+	const ESettingsField SaveDirty = Target.Diff(SaveGame->Data);
+	const bool bCustomDirty = CustomSettings.HasDirty();
+	LastAppliedFields = EngineDirty;
 
-		if (UWorld* World = GetWorld())
+	// The frame rate limit also depends on the refresh rate and window mode
+	if (EnumHasAnyFlags(EngineDirty, ESettingsField::NonResolution | ESettingsField::RefreshRate | ESettingsField::WindowMode))
+	{
+		// Groups are set one by one so a Custom mix applies the same way as a uniform level
+		for (int32 i = 0; i < ScalabilityGroup::Num; ++i)
 		{
-			FString Cmd = FString::Printf(TEXT("r.ToneMapperGamma %.2f"), Gamma);
-			World->Exec(World, *Cmd);
+			const EScalabilityGroup Group = static_cast<EScalabilityGroup>(i);
+			SetScalabilityGroupLevel(GS, Group, ScalabilityGroup::Level(Target, Group));
 		}
+		GS->SetResolutionScaleValueEx(Target.ScreenPercentage);
+		GS->SetFrameRateLimit(GetEngineFrameRateLimit(Target));
+		GS->SetVSyncEnabled(Target.bVSync);
+		GS->SetDynamicResolutionEnabled(Target.bDynamicResolution);
+		GS->ApplyNonResolutionSettings();
 	}
-	if (PendingSettings.ResolutionIndex >= 0 && CachedResolutions.IsValidIndex(PendingSettings.ResolutionIndex))
+	// Applying makes any preview permanent
+	PreviewTransaction.Reset();
+	FSettingsCVarTransaction CVarTransaction;
+	StageSettingsCVars(CVarTransaction, Target, EngineDirty);
+	CVarTransaction.Commit();
+	if (EnumHasAnyFlags(EngineDirty, ESettingsField::LatencyMode))
 	{
-		SaveGame->Data.ResolutionIndex = PendingSettings.ResolutionIndex;
-		GS->SetScreenResolution(CachedResolutions[PendingSettings.ResolutionIndex]);
-		GS->ApplyResolutionSettings(false);
+		// Shows up in "stat SSPCore" next to "stat unit", and marks the switch in CSV captures
+		SET_DWORD_STAT(STAT_SSPLatencyMode, Target.LatencyMode);
+		CSV_EVENT_GLOBAL(TEXT("SSPLatencyMode=%d"), Target.LatencyMode);
 	}
-	if (PendingSettings.WindowMode >= 0)
+	ApplyChannelVolumes(Target);
+	ApplyCustomSettings(false);
+	// Resolution and window mode share one swapchain change
+	if (EnumHasAnyFlags(EngineDirty, ESettingsField::Display))
 	{
-		EWindowMode::Type Mode =
-			PendingSettings.WindowMode == 0 ? EWindowMode::Fullscreen :
-			PendingSettings.WindowMode == 1 ? EWindowMode::WindowedFullscreen : EWindowMode::Windowed;
-		GS->SetFullscreenMode(Mode);
-		int32 CurrentIndex = CachedResolutions.Find(GS->GetScreenResolution());
-		switch (Mode)
+		if (Resolutions.IsValidIndex(Target.ResolutionIndex))
 		{
-		case EWindowMode::Fullscreen:
-			break;
-		case EWindowMode::WindowedFullscreen:
-			if (CurrentIndex >= 0 && CachedResolutions.IsValidIndex(CurrentIndex))
-			{
-				PendingSettings.ResolutionIndex = CurrentIndex;
-				SaveGame->Data.ResolutionIndex = CurrentIndex;
-				GS->SetScreenResolution(CachedResolutions[PendingSettings.ResolutionIndex]);
-				GS->ApplyResolutionSettings(false);
-			}
-			GS->ApplyResolutionSettings(false);
-			break;
-		case EWindowMode::Windowed:
-			break;
-		case EWindowMode::NumWindowModes:
-			break;
+			GS->SetScreenResolution(Resolutions[Target.ResolutionIndex]);
 		}
-		SaveGame->Data.WindowMode = PendingSettings.WindowMode;
+		GS->SetFullscreenMode(ToEngineWindowMode(Target.WindowMode));
+		GS->ApplyResolutionSettings(false);
+		PersistStartupDisplay();
+	}
+	if (EnumHasAnyFlags(EngineDirty, ESettingsField::NonResolution | ESettingsField::Display))
+	{
+		bGameUserSettingsDirty = true;
+	}
+
+	// The save keeps what the player chose; AppliedSettings only what the engine took
+	FUserSettingsData Applied = Target;
+	KeepUnappliedCVarFields(Applied, AppliedSettings, CVarTransaction);
+	AppliedSettings = Applied;
+	RefreshCurrentResolutionIndex();
+	if (SaveDirty != ESettingsField::None || bCustomDirty)
+	{
+		SaveGame->Data = Target;
+		CustomSettings.SaveTo(SaveGame->CustomSettings);
+		InvalidateCurrentSettings();
+		PersistSaveGame();
 	}
 
-	GS->ApplySettings(false);
-	GS->SaveSettings();
-	SaveGame->SaveData(PendingSettings);
-	UGameplayStatics::SaveGameToSlot(SaveGame, "YenumUserSettings", 0);
 	OnSettingsApplied.Broadcast(SaveGame);
 	PendingSettings.Reset();
+	bHasPendingChanges = false;
+	InvalidateCurrentSettings();
+	RefreshActivePreset();
+}
+
+void USettingsSubsystem::ApplyPreset(const USettingsPreset* Preset)
+{
+	if (!Preset)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ApplyPreset: Invalid preset"));
+		return;
+	}
+
+	// Only the performance fields come from the preset; anything else already queued rides along
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	const FUserSettingsData PresetValues = Preset->GetResolvedSettings();
+	for (int32 i = 0; i < Schema.NumBuiltIn(); ++i)
+	{
+		if (EnumHasAnyFlags(Schema[i].Field, ESettingsField::Performance))
+		{
+			Schema.WritePending(i, PendingSettings, Schema.ReadUser(i, PresetValues));
+		}
+	}
+	bHasPendingChanges = true;
+	InvalidateCurrentSettings();
+
+	ApplySettings();
+}
+
+void USettingsSubsystem::HandlePresetsLoaded()
+{
+	Presets.Reset();
+	for (const TSoftObjectPtr<USettingsPreset>& Asset : PresetAssets)
+	{
+		if (USettingsPreset* Preset = Asset.Get())
+		{
+			Presets.Add(Preset);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SettingsSubsystem: preset %s failed to load"), *Asset.ToString());
+		}
+	}
+	RefreshActivePreset();
+}
+
+void USettingsSubsystem::RefreshActivePreset()
+{
+	if (!bSettingsReady || !SaveGame)
+	{
+		return;
+	}
+
+	const FUserSettingsData Current = SaveGame->Data.MergedWith(FPendingSettings());
+	USettingsPreset* Match = nullptr;
+	for (USettingsPreset* Preset : Presets)
+	{
+		if ((Current.Diff(Preset->GetResolvedSettings()) & ESettingsField::Performance) == ESettingsField::None)
+		{
+			Match = Preset;
+			break;
+		}
+	}
+
+	if (Match != ActivePreset)
+	{
+		ActivePreset = Match;
+		OnSettingsPresetChanged.Broadcast(ActivePreset);
+	}
+}
+
+void USettingsSubsystem::CaptureAppliedSettingsFromEngine()
+{
+	auto* GS = GEngine->GetGameUserSettings();
+
+	// Volumes are driven by ApplySoundSettings, only engine-facing fields matter here
+	AppliedSettings = SaveGame->Data;
+	const Scalability::FQualityLevels EngineLevels = Scalability::GetQualityLevels();
+	for (int32 i = 0; i < ScalabilityGroup::Num; ++i)
+	{
+		const EScalabilityGroup Group = static_cast<EScalabilityGroup>(i);
+		ScalabilityGroup::Level(AppliedSettings, Group) = ScalabilityGroup::Level(EngineLevels, Group);
+	}
+	AppliedSettings.GraphicsQuality = AppliedSettings.GetUniformScalabilityLevel();
+	AppliedSettings.WindowMode = GetCurrentWindowMode();
+	AppliedSettings.ResolutionIndex = CurrentResolutionIndex;
+	AppliedSettings.Resolution = GS->GetScreenResolution();
+	AppliedSettings.FrameRateLimit = GS->GetFrameRateLimit();
+	AppliedSettings.bVSync = GS->IsVSyncEnabled();
+	AppliedSettings.bDynamicResolution = GS->IsDynamicResolutionEnabled();
+	float ScaleNormalized = 0.f, ScaleMin = 0.f, ScaleMax = 0.f;
+	GS->GetResolutionScaleInformationEx(ScaleNormalized, AppliedSettings.ScreenPercentage, ScaleMin, ScaleMax);
+	AppliedSettings.DynResMinScreenPercentage = SettingsCVars::GetFloat(ESettingsCVar::DynResMinScreenPercentage, AppliedSettings.DynResMinScreenPercentage);
+	AppliedSettings.DynResMaxScreenPercentage = SettingsCVars::GetFloat(ESettingsCVar::DynResMaxScreenPercentage, AppliedSettings.DynResMaxScreenPercentage);
+	AppliedSettings.DynResFrameTimeBudgetMs = SettingsCVars::GetFloat(ESettingsCVar::DynResFrameTimeBudget, AppliedSettings.DynResFrameTimeBudgetMs);
+	// r.ToneMapperGamma defaults to 0; clamp like the apply path so an unchanged brightness is not dirty
+	AppliedSettings.Brightness = FMath::Clamp(SettingsCVars::GetFloat(ESettingsCVar::ToneMapperGamma, AppliedSettings.Brightness), 0.5f, 3.0f);
 }
 
-void USettingsSubsystem::ApplySoundSettings(USoundMix* SoundMix, USoundClass* SoundClass, EVolumeType SoundType) const
+void USettingsSubsystem::ApplySoundSettings(USoundMix* SoundMix, USoundClass* SoundClass, EVolumeType SoundType)
 {
 	if (!SoundMix || !SoundClass)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("ApplySoundSettings: Invalid SoundMix or SoundClass"));
 		return;
 	}
-	float Volume = -1.0f;
-	switch (SoundType)
-	{
-	case EVolumeType::EVT_Master:
-        Volume = PendingSettings.MasterVolume;
-		SaveGame->Data.MasterVolume = Volume;
-		break;
-	case EVolumeType::EVT_SFX:
-        SaveGame->Data.MasterVolume = PendingSettings.SFXVolume;
-		SaveGame->Data.SFXVolume = Volume;
-		break;
-	case EVolumeType::EVT_Dialogue:
-        Volume = PendingSettings.DialogueVolume;
-		SaveGame->Data.DialogueVolume = Volume;
-		break;
-	default:
+	if (!bSettingsReady)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ApplySoundSettings: settings are still loading, ignored"));
+		return;
+	}
+	const FName Channel = GetVolumeChannelName(SoundType);
+	if (Channel.IsNone())
+	{
 		return;
 	}
-	if (Volume < 0.0f)
-	{
-		return; // not queued
-	}
-    Volume = FMath::Clamp(Volume, 0.0f, 1.0f);
-	// Apply sound class override
-	UGameplayStatics::SetSoundMixClassOverride(
-		this,
-		SoundMix,
-		SoundClass,
-		Volume,
-		1.0f    // Pitch
-	);
-	SaveGame->SaveData(PendingSettings);
-	UGameplayStatics::SaveGameToSlot(SaveGame, "YenumUserSettings", 0);
-	//Activate Mix
-	UGameplayStatics::PushSoundMixModifier(this, SoundMix);
+	SetVolumeSoundMix(SoundMix);
+	RegisterAudioChannel(Channel, SoundClass);
+	CommitVolumes();
 	OnSoundSettingsApplied.Broadcast(SoundType);
 }
 
+void USettingsSubsystem::SetVolumeSoundMix(USoundMix* SoundMix)
+{
+	if (SoundMix == VolumeSoundMix)
+	{
+		return;
+	}
+	FAudioDevice* AudioDevice = GEngine ? GEngine->GetMainAudioDeviceRaw() : nullptr;
+	if (AudioDevice && VolumeSoundMix && bVolumeMixPushed)
+	{
+		AudioDevice->PopSoundMixModifier(VolumeSoundMix);
+	}
+	VolumeSoundMix = SoundMix;
+	bVolumeMixPushed = false;
+	AppliedChannelVolumes.Reset();
+	if (bSettingsReady)
+	{
+		ApplyChannelVolumes(SaveGame->Data);
+	}
+}
+
+void USettingsSubsystem::RegisterAudioChannel(FName Channel, USoundClass* SoundClass)
+{
+	if (Channel.IsNone() || !SoundClass)
+	{
+		return;
+	}
+	TObjectPtr<USoundClass>& Registered = ChannelSoundClasses.FindOrAdd(Channel);
+	if (Registered != SoundClass)
+	{
+		Registered = SoundClass;
+		AppliedChannelVolumes.Remove(Channel);
+		if (bSettingsReady)
+		{
+			ApplyChannelVolumes(SaveGame->Data);
+		}
+	}
+}
+
+TArray<FName> USettingsSubsystem::GetAudioChannels() const
+{
+	TArray<FName> Channels;
+	for (const FSettingsAudioChannel& Row : AudioChannels)
+	{
+		Channels.AddUnique(Row.Channel);
+	}
+	for (const TPair<FName, TObjectPtr<USoundClass>>& Channel : ChannelSoundClasses)
+	{
+		Channels.AddUnique(Channel.Key);
+	}
+	return Channels;
+}
+
+float USettingsSubsystem::GetChannelVolume(FName Channel) const
+{
+	const float Queued = PendingSettings.GetChannelVolume(Channel);
+	if (Queued >= 0.0f)
+	{
+		return Queued;
+	}
+	const FUserSettingsData& Current = SaveGame ? SaveGame->Data : DefaultSettings;
+	return Current.GetChannelVolume(Channel, GetChannelDefaultVolume(Channel));
+}
+
+FName USettingsSubsystem::GetVolumeChannelName(EVolumeType VolumeType)
+{
+	switch (VolumeType)
+	{
+	case EVolumeType::EVT_Master: return SettingsAudioChannels::Master;
+	case EVolumeType::EVT_SFX: return SettingsAudioChannels::SFX;
+	case EVolumeType::EVT_Dialogue: return SettingsAudioChannels::Dialogue;
+	default: return NAME_None;
+	}
+}
+
+float USettingsSubsystem::GetChannelDefaultVolume(FName Channel) const
+{
+	for (const FSettingsAudioChannel& Row : AudioChannels)
+	{
+		if (Row.Channel == Channel)
+		{
+			return Row.DefaultVolume;
+		}
+	}
+	return 1.0f;
+}
+
+void USettingsSubsystem::ApplyChannelVolumes(const FUserSettingsData& Target)
+{
+	FAudioDevice* AudioDevice = GEngine ? GEngine->GetMainAudioDeviceRaw() : nullptr;
+	if (!AudioDevice || !VolumeSoundMix)
+	{
+		return;
+	}
+
+	bool bChanged = false;
+	for (const TPair<FName, TObjectPtr<USoundClass>>& Channel : ChannelSoundClasses)
+	{
+		if (!Channel.Value)
+		{
+			continue;
+		}
+		const float Volume = FMath::Clamp(Target.GetChannelVolume(Channel.Key, GetChannelDefaultVolume(Channel.Key)), 0.0f, 1.0f);
+		const float* Applied = AppliedChannelVolumes.Find(Channel.Key);
+		if (Applied && FMath::IsNearlyEqual(*Applied, Volume))
+		{
+			continue;
+		}
+		AudioDevice->SetSoundMixClassOverride(VolumeSoundMix, Channel.Value, Volume, 1.0f, 0.0f, true);
+		AppliedChannelVolumes.Add(Channel.Key, Volume);
+		bChanged = true;
+	}
+
+	// Overrides on an active mix update in place, so the modifier is pushed exactly once
+	if (bChanged && !bVolumeMixPushed)
+	{
+		AudioDevice->PushSoundMixModifier(VolumeSoundMix);
+		bVolumeMixPushed = true;
+	}
+}
+
+void USettingsSubsystem::CommitVolumes()
+{
+	FPendingSettings QueuedVolumes;
+	QueuedVolumes.MasterVolume = PendingSettings.MasterVolume;
+	QueuedVolumes.SFXVolume = PendingSettings.SFXVolume;
+	QueuedVolumes.DialogueVolume = PendingSettings.DialogueVolume;
+	QueuedVolumes.ChannelVolumes = MoveTemp(PendingSettings.ChannelVolumes);
+	PendingSettings.MasterVolume = -1.0f;
+	PendingSettings.SFXVolume = -1.0f;
+	PendingSettings.DialogueVolume = -1.0f;
+	PendingSettings.ChannelVolumes.Reset();
+	bHasPendingChanges = PendingSettings.IsValid();
+	InvalidateCurrentSettings();
+
+	const FUserSettingsData Target = SaveGame->Data.MergedWith(QueuedVolumes);
+	ApplyChannelVolumes(Target);
+	if (Target.Diff(SaveGame->Data) != ESettingsField::None)
+	{
+		SaveGame->Data = Target;
+		InvalidateCurrentSettings();
+		PersistSaveGame();
+	}
+}
+
+TUniquePtr<FSettingsPersistence> USettingsSubsystem::ReplacePersistence(TUniquePtr<FSettingsPersistence> Store)
+{
+	Swap(Persistence, Store);
+	return Store;
+}
+
+TUniquePtr<FSettingsPersistence> USettingsSubsystem::ReplaceStartupDisplayStore(TUniquePtr<FSettingsPersistence> Store)
+{
+	Swap(StartupDisplayStore, Store);
+	return Store;
+}
+
+void USettingsSubsystem::PersistSaveGame()
+{
+	// Serializing is cheap; the disk work happens on the persistence task
+	TArray<uint8> Bytes;
+	if (Persistence && UGameplayStatics::SaveGameToMemory(SaveGame, Bytes))
+	{
+		Persistence->Write(MoveTemp(Bytes));
+	}
+}
+
+bool USettingsSubsystem::FlushVolumePreview(float DeltaTime)
+{
+	VolumePreviewTicker.Reset();
+	if (bSettingsReady)
+	{
+		ApplyChannelVolumes(SaveGame->Data.MergedWith(PendingSettings));
+	}
+	return false;
+}
+
+void USettingsSubsystem::HandleAudioAssetsLoaded()
+{
+	if (!VolumeSoundMix)
+	{
+		SetVolumeSoundMix(VolumeSoundMixAsset.Get());
+	}
+	for (const FSettingsAudioChannel& Row : AudioChannels)
+	{
+		RegisterAudioChannel(Row.Channel, Row.SoundClass.Get());
+	}
+}
+
+void USettingsSubsystem::PreviewPendingSettings()
+{
+	if (!bSettingsReady)
+	{
+		return;
+	}
+	FUserSettingsData Target = SaveGame->Data.MergedWith(PendingSettings);
+	Target.ClampPerformanceFields();
+
+	// One transaction covers every preview since the last apply, so revert restores the applied values
+	PreviewTransaction.Rollback();
+	StageSettingsCVars(PreviewTransaction, Target, Target.Diff(AppliedSettings));
+	PreviewTransaction.Commit();
+}
+
 void USettingsSubsystem::RevertPendingSettings()
 {
+	PreviewTransaction.Rollback();
 	PendingSettings = {};
+	InvalidateCurrentSettings();
+	if (SaveGame)
+	{
+		CustomSettings.LoadFrom(SaveGame->CustomSettings);
+	}
+	if (bSettingsReady)
+	{
+		// Undo any volume preview
+		ApplyChannelVolumes(SaveGame->Data);
+	}
     OnSettingsReverted.Broadcast(PendingSettings);
 }
 
 void USettingsSubsystem::ResetToDefaults()
 {
-	auto* GS = GEngine->GetGameUserSettings();
 	PendingSettings = DefaultSettings.GetAsPendingSettings();
-	PendingSettings.ResolutionIndex = CachedResolutions.Find(GS->GetScreenResolution());
+	PendingSettings.ResolutionIndex = CurrentResolutionIndex;
+	if (SaveGame)
+	{
+		for (const TPair<FName, float>& Channel : SaveGame->Data.ChannelVolumes)
+		{
+			PendingSettings.ChannelVolumes.Add(Channel.Key, GetChannelDefaultVolume(Channel.Key));
+		}
+	}
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	for (int32 i = Schema.NumBuiltIn(); i < Schema.Num(); ++i)
+	{
+		CustomSettings.Set(i, Schema[i].Default);
+	}
+	InvalidateCurrentSettings();
 	OnSettingsResetToDefaults.Broadcast(PendingSettings);
 	ApplySettings();
 }
 
+bool USettingsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Scalability, gamma, resolution and audio have nothing to drive on a dedicated server.
+	// The BFL already treats a missing subsystem as a no-op.
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
 void USettingsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
-	if (UGameplayStatics::DoesSaveGameExist("YenumUserSettings", 0))
+	// UGeneralSettingsBFL::InitSettings used to call Initialize a second time
+	if (bInitializeStarted)
 	{
-		SaveGame = Cast<USettingsSaveGame>(
-			UGameplayStatics::LoadGameFromSlot("YenumUserSettings", 0));
-		PendingSettings = SaveGame->Data.GetAsPendingSettings();
-			OnSettingsInitialized.Broadcast(PendingSettings);
-			ApplySettings();
+		return;
 	}
-	else
+	bInitializeStarted = true;
+	LLM_SCOPE_BYTAG(SSPCore_SettingsSubsystem);
+	InitializeStartSeconds = FPlatformTime::Seconds();
+
+	SettingsReadyFuture = SettingsReadyPromise.GetFuture().Share();
+
+	FDisplayMetrics Metrics;
+	FDisplayMetrics::RebuildDisplayMetrics(Metrics);
+	RebuildResolutionCache(Metrics);
+	if (FSlateApplication::IsInitialized())
 	{
-		SaveGame = Cast<USettingsSaveGame>(UGameplayStatics::CreateSaveGameObject(USettingsSaveGame::StaticClass()));
-		PendingSettings = SaveGame->Data.GetAsPendingSettings();
-		OnSettingsInitialized.Broadcast(PendingSettings);
+		DisplayMetricsChangedHandle = FSlateApplication::Get().GetPlatformApplication()->OnDisplayMetricsChanged().AddUObject(
+			this, &USettingsSubsystem::HandleDisplayMetricsChanged);
 	}
+
+	// Defaults serve queries until the slot arrives
+	SaveGame = Cast<USettingsSaveGame>(UGameplayStatics::CreateSaveGameObject(USettingsSaveGame::StaticClass()));
+	CustomSettings.Reset();
+	InvalidateCurrentSettings();
+	CaptureAppliedSettingsFromEngine();
+
+	if (PresetAssets.Num() > 0)
+	{
+		TArray<FSoftObjectPath> PresetPaths;
+		for (const TSoftObjectPtr<USettingsPreset>& Asset : PresetAssets)
+		{
+			PresetPaths.Add(Asset.ToSoftObjectPath());
+		}
+		UAssetManager::GetStreamableManager().RequestAsyncLoad(PresetPaths,
+			FStreamableDelegate::CreateUObject(this, &USettingsSubsystem::HandlePresetsLoaded));
+	}
+
+	TArray<FSoftObjectPath> AudioPaths;
+	if (!VolumeSoundMixAsset.IsNull())
+	{
+		AudioPaths.Add(VolumeSoundMixAsset.ToSoftObjectPath());
+	}
+	for (const FSettingsAudioChannel& Row : AudioChannels)
+	{
+		if (!Row.SoundClass.IsNull())
+		{
+			AudioPaths.Add(Row.SoundClass.ToSoftObjectPath());
+		}
+	}
+	if (AudioPaths.Num() > 0)
+	{
+		UAssetManager::GetStreamableManager().RequestAsyncLoad(AudioPaths,
+			FStreamableDelegate::CreateUObject(this, &USettingsSubsystem::HandleAudioAssetsLoaded));
+	}
+
+	// Reads and verifies on a worker; the callback comes back on the game thread
+	Persistence = MakeUnique<FSettingsPersistence>(
+		FPaths::ProjectSavedDir() / TEXT("SaveGames") / FString(SettingsSlotName) + TEXT(".settings"));
+	Persistence->LoadAsync([WeakThis = TWeakObjectPtr<USettingsSubsystem>(this)](TArray<uint8>&& Payload)
+	{
+		if (USettingsSubsystem* Self = WeakThis.Get())
+		{
+			Self->HandleSnapshotLoaded(MoveTemp(Payload));
+		}
+	});
+	StartupDisplayStore = MakeUnique<FSettingsPersistence>(FStartupDisplaySettings::GetPath());
+	StartupDisplayBytes.Reset();
+	if (const TOptional<FStartupDisplaySettings>& OnDisk = FStartupDisplaySettings::GetLoaded())
+	{
+		OnDisk->Serialize(StartupDisplayBytes);
+	}
+
+	const uint64 PhysicalBytes = FPlatformMemory::GetConstants().TotalPhysical;
+	TexturePoolLimitMB = MemoryBudget::GetTexturePoolLimitMB(PhysicalBytes, MemoryBudget::GetVideoMemoryBytes());
+	// Ticks every frame and measures the interval itself, so ssp.Memory.PollInterval changes apply at once
+	MemoryPressureTicker = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &USettingsSubsystem::TickMemoryPressure));
+
+	InitializeMs = (FPlatformTime::Seconds() - InitializeStartSeconds) * 1000.0;
+}
+
+EHardwareTier USettingsSubsystem::GetHardwareTier() const
+{
+	return SaveGame ? SaveGame->HardwareTier : EHardwareTier::Unknown;
+}
+
+const TArray<FHardwareTierProfile>& USettingsSubsystem::GetHardwareTierProfiles() const
+{
+	return HardwareTiers.Num() > 0 ? HardwareTiers : HardwareTier::GetBuiltInProfiles();
+}
+
+FPendingSettings USettingsSubsystem::ResolveHardwareTier(bool& bOutClassified)
+{
+	bOutClassified = false;
+	const TArray<FHardwareTierProfile>& Profiles = GetHardwareTierProfiles();
+	int32 Index = Profiles.IndexOfByPredicate([this](const FHardwareTierProfile& Profile)
+	{
+		return Profile.Tier == SaveGame->HardwareTier;
+	});
+	if (Index == INDEX_NONE)
+	{
+		// First run, a save from before tiering, or the tier was removed from the table
+		const FHardwareDescription Hardware = HardwareTier::Describe();
+		Index = HardwareTier::Classify(Hardware, Profiles);
+		if (Index == INDEX_NONE)
+		{
+			return FPendingSettings();
+		}
+		UE_LOG(LogTemp, Log, TEXT("Settings: hardware tier %s (%d cores, %d MHz, %d MB RAM, %d MB VRAM%s, \"%s\")"),
+			*UEnum::GetDisplayValueAsText(Profiles[Index].Tier).ToString(), Hardware.NumCores, Hardware.CpuClockMHz,
+			Hardware.MemoryMB, Hardware.VideoMemoryMB, Hardware.bIntegratedGPU ? TEXT(", integrated") : TEXT(""),
+			*Hardware.AdapterName);
+		// Without a GPU to look at (-nullrhi, headless) the tier only holds for this session,
+		// so the first run with a real RHI classifies again
+		if (Hardware.bHasRHI)
+		{
+			SaveGame->HardwareTier = Profiles[Index].Tier;
+			bOutClassified = true;
+		}
+	}
+
+	// Only performance fields, the same ones ApplyPreset takes from a preset
+	const FHardwareTierProfile& Profile = Profiles[Index];
+	FPendingSettings TierSettings;
+	TierSettings.GraphicsQuality = Profile.GraphicsQuality;
+	if (!Profile.Preset.IsNull())
+	{
+		// One small data asset, usually also in PresetAssets and so already loaded
+		if (const USettingsPreset* Preset = Profile.Preset.LoadSynchronous())
+		{
+			const FSettingsSchema& Schema = FSettingsSchema::Get();
+			const FUserSettingsData PresetValues = Preset->GetResolvedSettings();
+			for (int32 i = 0; i < Schema.NumBuiltIn(); ++i)
+			{
+				if (EnumHasAnyFlags(Schema[i].Field, ESettingsField::Performance))
+				{
+					Schema.WritePending(i, TierSettings, Schema.ReadUser(i, PresetValues));
+				}
+			}
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Settings: tier preset %s failed to load"), *Profile.Preset.ToString());
+		}
+	}
+	// Memory budgets never come from the tier: presets leave them alone, and the pool is
+	// sized for this machine's RAM and video memory rather than its class
+	const uint64 PhysicalBytes = FPlatformMemory::GetConstants().TotalPhysical;
+	TierSettings.TexturePoolSizeMB = MemoryBudget::GetDefaultTexturePoolMB(PhysicalBytes, MemoryBudget::GetVideoMemoryBytes());
+	if (bOutClassified)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Settings: texture pool %d MB for %llu MB RAM"),
+			TierSettings.TexturePoolSizeMB, PhysicalBytes / (1024 * 1024));
+	}
+
+	// Reset to Defaults returns to the tier, not to the values compiled in
+	DefaultSettings = FUserSettingsData().MergedWith(TierSettings);
+	DefaultSettings.ClampPerformanceFields();
+	InvalidateCurrentSettings();
+	return TierSettings;
+}
+
+bool USettingsSubsystem::TickMemoryPressure(float DeltaTime)
+{
+	const float Interval = CVarSSPMemoryPollInterval.GetValueOnGameThread();
+	if (Interval <= 0.0f)
+	{
+		MemoryPollElapsed = 0.0f;
+		return true;
+	}
+	MemoryPollElapsed += DeltaTime;
+	if (MemoryPollElapsed < FMath::Max(Interval, 0.1f))
+	{
+		return true;
+	}
+	MemoryPollElapsed = 0.0f;
+	const FSettingsMemoryPressure Sampled = MemoryBudget::Sample(TexturePoolLimitMB);
+	const bool bChanged = !(Sampled == MemoryPressure);
+	MemoryPressure = Sampled;
+	if (bChanged)
+	{
+		if (Sampled.bOverBudget)
+		{
+			UE_LOG(LogTemp, Log, TEXT("Settings: texture pool %d MB over budget by %d MB, recommended %d MB%s"),
+				Sampled.PoolSizeMB, Sampled.OverBudgetMB, Sampled.RecommendedPoolSizeMB,
+				Sampled.bAtMemoryLimit ? TEXT(" (machine limit)") : TEXT(""));
+		}
+		OnMemoryPressureChanged.Broadcast(MemoryPressure);
+	}
+	return true;
+}
+
+void USettingsSubsystem::HandleSnapshotLoaded(TArray<uint8>&& Payload)
+{
+	if (Payload.Num() > 0)
+	{
+		HandleSaveGameLoaded(SettingsSlotName, 0, UGameplayStatics::LoadGameFromMemory(Payload));
+		return;
+	}
+
+	// No intact snapshot: fall back to the save slot used before the snapshot store and
+	// carry it over, so the next start reads the snapshot
+	UGameplayStatics::AsyncLoadGameFromSlot(SettingsSlotName, 0, FAsyncLoadGameFromSlotDelegate::CreateWeakLambda(this,
+		[this](const FString& SlotName, const int32 UserIndex, USaveGame* Loaded)
+		{
+			HandleSaveGameLoaded(SlotName, UserIndex, Loaded);
+			if (Loaded)
+			{
+				PersistSaveGame();
+			}
+		}));
+}
+
+void USettingsSubsystem::PersistStartupDisplay()
+{
+	const UGameUserSettings* GS = GEngine->GetGameUserSettings();
+	if (!StartupDisplayStore || !GS)
+	{
+		return;
+	}
+	FStartupDisplaySettings Display;
+	Display.Resolution = GS->GetScreenResolution();
+	Display.FullscreenMode = static_cast<int32>(GS->GetFullscreenMode());
+	TArray<uint8> Bytes;
+	Display.Serialize(Bytes);
+	if (Bytes == StartupDisplayBytes)
+	{
+		return;
+	}
+	StartupDisplayBytes = Bytes;
+	StartupDisplayStore->Write(MoveTemp(Bytes));
+}
+
+void USettingsSubsystem::HandleSaveGameLoaded(const FString& SlotName, const int32 UserIndex, USaveGame* Loaded)
+{
+	LLM_SCOPE_BYTAG(SSPCore_SettingsSubsystem);
+	const bool bHasSave = Loaded && Loaded->IsA<USettingsSaveGame>();
+	bool bMigratedResolution = false;
+	if (bHasSave)
+	{
+		SaveGame = CastChecked<USettingsSaveGame>(Loaded);
+		if (SaveGame->Data.Resolution == FIntPoint::ZeroValue)
+		{
+			// Saved before the size was stored: the index is into the old, unsorted list
+			SaveGame->Data.Resolution = DisplayModes.GetLegacyResolution(SaveGame->Data.ResolutionIndex);
+			bMigratedResolution = true;
+		}
+		ResolveResolutionIndex(SaveGame->Data);
+		InvalidateCurrentSettings();
+	}
+
+	// Anything the UI queued while loading stays queued on top of the saved values
+	const FPendingSettings QueuedDuringLoad = PendingSettings;
+	const FSettingsValues QueuedCustomDuringLoad = CustomSettings;
+	PendingSettings.Reset();
+	CustomSettings.LoadFrom(SaveGame->CustomSettings);
+	bSettingsReady = true;
+
+	bool bTierClassified = false;
+	const FPendingSettings TierSettings = ResolveHardwareTier(bTierClassified);
+	if (!bHasSave)
+	{
+		// Nothing saved yet: start from the machine's defaults instead of the engine's
+		PendingSettings = TierSettings;
+	}
+	if (bHasSave && EnumHasAnyFlags(SaveGame->Data.Diff(AppliedSettings), ESettingsField::Display))
+	{
+		// SSPCoreStartup normally has the window at the saved mode already; this costs a second swapchain
+		UE_LOG(LogTemp, Log, TEXT("Settings: window was not created with the saved display mode, applying it now"));
+	}
+	if (bHasSave || PendingSettings.IsValid())
+	{
+		// GameUserSettings.ini usually restored most of this already, only re-apply the difference
+		ApplySettings();
+	}
+	if (bTierClassified || bMigratedResolution)
+	{
+		// The apply skips the disk when neither changed what was already running
+		PersistSaveGame();
+	}
+
+	// The mix may still be at engine defaults if there was no save to apply
+	ApplyChannelVolumes(SaveGame->Data);
+	// Registered settings have no engine-side copy to diff against, push all of them once
+	ApplyCustomSettings(true);
+	QueuedCustomDuringLoad.ForEachDirty([this](int32 Index, float Value)
+	{
+		CustomSettings.Set(Index, Value);
+	});
+
+	PendingSettings = QueuedDuringLoad;
+	bHasPendingChanges = PendingSettings.IsValid() || CustomSettings.HasDirty();
+	InvalidateCurrentSettings();
+	OnSettingsInitialized.Broadcast(GetCurrentSettingsData());
+
+	if (bApplyWhenReady)
+	{
+		bApplyWhenReady = false;
+		ApplySettings();
+	}
+
+	// Keeps the startup copy in step with saves from before it existed, or written by another build.
+	// Writes only when the file differs from what was loaded.
+	PersistStartupDisplay();
+	RefreshActivePreset();
+	TimeToReadyMs = (FPlatformTime::Seconds() - InitializeStartSeconds) * 1000.0;
+	SettingsReadyPromise.SetValue();
+	OnSettingsReady.Broadcast();
 }
 
 void USettingsSubsystem::QueueGraphicsQuality(int32 Level)
 {
+	// A new overall level replaces any group overrides queued before it
+	for (int32 i = 0; i < ScalabilityGroup::Num; ++i)
+	{
+		ScalabilityGroup::Level(PendingSettings, static_cast<EScalabilityGroup>(i)) = -1;
+	}
 	PendingSettings.GraphicsQuality = Level;
 	bHasPendingChanges = true;
+	InvalidateCurrentSettings();
 	OnSettingsQueued.Broadcast();
 }
 
-void USettingsSubsystem::QueueBrightness(float Value)
+void USettingsSubsystem::QueueScalabilityGroup(EScalabilityGroup Group, int32 Level)
 {
-	PendingSettings.Brightness = Value;
+	if (Group == EScalabilityGroup::Num)
+	{
+		return;
+	}
+	ScalabilityGroup::Level(PendingSettings, Group) = Level;
 	bHasPendingChanges = true;
+	InvalidateCurrentSettings();
 	OnSettingsQueued.Broadcast();
 }
 
+void USettingsSubsystem::QueueBrightness(float Value)
+{
+	QueueSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, Brightness), Value);
+}
+
+void USettingsSubsystem::QueueSetting(FName Key, float Value)
+{
+	if (StageSetting(Key, Value))
+	{
+		bHasPendingChanges = true;
+		OnSettingsQueued.Broadcast();
+	}
+}
+
+bool USettingsSubsystem::StageSetting(FName Key, float Value)
+{
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	const int32 Index = Schema.IndexOf(Key);
+	if (Index == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("QueueSetting: Unknown setting %s"), *Key.ToString());
+		return false;
+	}
+	if (Schema[Index].IsBuiltIn())
+	{
+		Schema.WritePending(Index, PendingSettings, Schema[Index].Sanitize(Value));
+		InvalidateCurrentSettings();
+	}
+	else
+	{
+		CustomSettings.Set(Index, Value);
+	}
+	return true;
+}
+
+float USettingsSubsystem::GetSettingValue(FName Key) const
+{
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	const int32 Index = Schema.IndexOf(Key);
+	if (Index == INDEX_NONE)
+	{
+		return 0.0f;
+	}
+	if (!Schema[Index].IsBuiltIn())
+	{
+		return CustomSettings.Get(Index);
+	}
+	const FUserSettingsData& Current = SaveGame ? SaveGame->Data : DefaultSettings;
+	return Current.GetMergedValue(Index, PendingSettings);
+}
+
+int32 USettingsSubsystem::GetScalabilityGroupLevel(EScalabilityGroup Group) const
+{
+	if (Group == EScalabilityGroup::Num)
+	{
+		return -1;
+	}
+	const FUserSettingsData& Current = SaveGame ? SaveGame->Data : DefaultSettings;
+	return Current.GetMergedScalabilityLevel(Group, PendingSettings);
+}
+
+void USettingsSubsystem::ApplyCustomSettings(bool bAll)
+{
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	if (bAll)
+	{
+		for (int32 i = Schema.NumBuiltIn(); i < Schema.Num(); ++i)
+		{
+			if (Schema[i].Applier)
+			{
+				Schema[i].Applier(CustomSettings.Get(i));
+			}
+		}
+	}
+	else
+	{
+		CustomSettings.ForEachDirty([&Schema](int32 Index, float Value)
+		{
+			if (Schema[Index].Applier)
+			{
+				Schema[Index].Applier(Value);
+			}
+		});
+	}
+	CustomSettings.ClearDirty();
+}
+
 void USettingsSubsystem::QueueVolume(float Value, EVolumeType VolumeType)
 {
-	switch (VolumeType)
+	QueueChannelVolume(GetVolumeChannelName(VolumeType), Value);
+}
+
+void USettingsSubsystem::QueueChannelVolume(FName Channel, float Value)
+{
+	if (Channel.IsNone())
 	{
-	case EVolumeType::EVT_Master:
-		PendingSettings.MasterVolume = Value;
-		break;
-	case EVolumeType::EVT_SFX:
-		PendingSettings.SFXVolume = Value;
-		break;
-	case EVolumeType::EVT_Dialogue:
-		PendingSettings.DialogueVolume = Value;
-		break;
-	case EVolumeType::EVT_MAX:
-		break;
+		return;
 	}
+	PendingSettings.SetChannelVolume(Channel, FMath::Clamp(Value, 0.0f, 1.0f));
 	bHasPendingChanges = true;
+	InvalidateCurrentSettings();
 	OnSettingsQueued.Broadcast();
 }
 
+void USettingsSubsystem::PreviewChannelVolume(FName Channel, float Value)
+{
+	QueueChannelVolume(Channel, Value);
+	if (!VolumePreviewTicker.IsValid())
+	{
+		VolumePreviewTicker = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateUObject(this, &USettingsSubsystem::FlushVolumePreview),
+			FMath::Max(CVarSSPAudioPreviewInterval.GetValueOnGameThread(), 0.0f));
+	}
+}
+
 void USettingsSubsystem::QueueResolution(int32 Index)
 {
-	PendingSettings.ResolutionIndex = Index;
-	bHasPendingChanges = true;
-	OnSettingsQueued.Broadcast();
+	QueueSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, ResolutionIndex), Index);
 }
 
 void USettingsSubsystem::QueueWindowMode(int32 Index)
 {
-	PendingSettings.WindowMode = Index;
+	QueueSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, WindowMode), Index);
+}
+
+void USettingsSubsystem::QueueFrameRateLimit(float FramesPerSecond)
+{
+	QueueSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, FrameRateLimit), FramesPerSecond);
+}
+
+void USettingsSubsystem::QueueVSync(bool bEnabled)
+{
+	QueueSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, VSync), bEnabled ? 1.0f : 0.0f);
+}
+
+void USettingsSubsystem::QueueLatencyMode(ELatencyMode Mode)
+{
+	QueueSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, LatencyMode), static_cast<float>(Mode));
+}
+
+void USettingsSubsystem::QueueTexturePoolSize(int32 MegaBytes)
+{
+	QueueSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, TexturePoolSizeMB), static_cast<float>(MegaBytes));
+}
+
+void USettingsSubsystem::QueueMeshPoolSize(int32 MegaBytes)
+{
+	QueueSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, MeshPoolSizeMB), static_cast<float>(MegaBytes));
+}
+
+void USettingsSubsystem::QueueScreenPercentage(float Percentage)
+{
+	QueueSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, ScreenPercentage), Percentage);
+}
+
+void USettingsSubsystem::QueueDynamicResolution(bool bEnabled)
+{
+	QueueSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, DynamicResolution), bEnabled ? 1.0f : 0.0f);
+}
+
+void USettingsSubsystem::QueueDynamicResolutionBudget(float MinScreenPercentage, float MaxScreenPercentage, float FrameTimeBudgetMs)
+{
+	StageSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, DynResMinScreenPercentage), MinScreenPercentage);
+	StageSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, DynResMaxScreenPercentage), MaxScreenPercentage);
+	StageSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, DynResFrameTimeBudgetMs), FrameTimeBudgetMs);
 	bHasPendingChanges = true;
 	OnSettingsQueued.Broadcast();
 }
 
-TArray<FString> USettingsSubsystem::GetAvailableResolutions()
+void USettingsSubsystem::Deinitialize()
+{
+	if (DisplayMetricsChangedHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().GetPlatformApplication()->OnDisplayMetricsChanged().Remove(DisplayMetricsChangedHandle);
+	}
+	DisplayMetricsChangedHandle.Reset();
+	if (VolumePreviewTicker.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(VolumePreviewTicker);
+		VolumePreviewTicker.Reset();
+	}
+	if (MemoryPressureTicker.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(MemoryPressureTicker);
+		MemoryPressureTicker.Reset();
+	}
+	if (bGameUserSettingsDirty)
+	{
+		GEngine->GetGameUserSettings()->SaveSettings();
+		bGameUserSettingsDirty = false;
+	}
+	if (Persistence)
+	{
+		Persistence->Flush();
+	}
+	if (StartupDisplayStore)
+	{
+		StartupDisplayStore->Flush();
+	}
+
+	Super::Deinitialize();
+}
+
+const TArray<FString>& USettingsSubsystem::GetAvailableResolutions() const
+{
+	return DisplayModes.GetResolutionLabels();
+}
+
+void USettingsSubsystem::RebuildResolutionCache(const FDisplayMetrics& Metrics)
+{
+	LLM_SCOPE_BYTAG(SSPCore_SettingsSubsystem);
+	// Indices move with the list; carry a queued one over by size
+	const TConstArrayView<FIntPoint> OldResolutions = DisplayModes.GetResolutions();
+	const FIntPoint Queued = OldResolutions.IsValidIndex(PendingSettings.ResolutionIndex)
+		? OldResolutions[PendingSettings.ResolutionIndex] : FIntPoint::ZeroValue;
+
+	DisplayModes.Rebuild(Metrics);
+	RefreshCurrentResolutionIndex();
+
+	if (Queued != FIntPoint::ZeroValue)
+	{
+		PendingSettings.ResolutionIndex = DisplayModes.FindResolution(Queued);
+	}
+	if (bSettingsReady)
+	{
+		ResolveResolutionIndex(SaveGame->Data);
+		AppliedSettings.ResolutionIndex = CurrentResolutionIndex;
+	}
+	InvalidateCurrentSettings();
+}
+
+void USettingsSubsystem::ResolveResolutionIndex(FUserSettingsData& Data) const
+{
+	const int32 Index = DisplayModes.FindResolution(Data.Resolution);
+	// A size the display no longer offers keeps the window where it is
+	Data.ResolutionIndex = Index != INDEX_NONE ? Index : CurrentResolutionIndex;
+}
+
+void USettingsSubsystem::RefreshCurrentResolutionIndex()
 {
-	if (CachedResolutions.Num() == 0)
+	CurrentResolutionIndex = DisplayModes.FindResolution(GEngine->GetGameUserSettings()->GetScreenResolution());
+}
+
+void USettingsSubsystem::HandleDisplayMetricsChanged(const FDisplayMetrics& Metrics)
+{
+	// A monitor was plugged, unplugged or changed mode: indices may have moved
+	RebuildResolutionCache(Metrics);
+}
+
+int32 USettingsSubsystem::GetCurrentMonitorIndex() const
+{
+	FIntPoint WindowCenter = FIntPoint::ZeroValue;
+	if (GEngine && GEngine->GameViewport)
 	{
-		FScreenResolutionArray Resolutions;
-		RHIGetAvailableResolutions(Resolutions, false);
-		for (const FScreenResolutionRHI& R : Resolutions)
+		if (const TSharedPtr<SWindow> Window = GEngine->GameViewport->GetWindow())
 		{
-			CachedResolutions.AddUnique(FIntPoint(R.Width, R.Height));
+			const FVector2D Position = Window->GetPositionInScreen();
+			const FVector2D Size = Window->GetSizeInScreen();
+			const FVector2D Center = Position + Size * 0.5;
+			WindowCenter = FIntPoint(FMath::RoundToInt(Center.X), FMath::RoundToInt(Center.Y));
 		}
 	}
-	
-	TArray<FString> Out;
-	for (const auto& R : CachedResolutions)
+	return DisplayModes.FindMonitor(WindowCenter);
+}
+
+void USettingsSubsystem::QueueDisplayMode(const FSettingsDisplayMode& Mode)
+{
+	const int32 Index = DisplayModes.FindResolution(Mode.GetResolution());
+	if (Index == INDEX_NONE || (Mode.RefreshRate > 0 && DisplayModes.FindMode(Mode) == INDEX_NONE))
 	{
-		Out.Add(FString::Printf(TEXT("%d x %d"), R.X, R.Y));
+		UE_LOG(LogTemp, Warning, TEXT("QueueDisplayMode: %d x %d @ %d Hz is not an available mode"),
+			Mode.Width, Mode.Height, Mode.RefreshRate);
+		return;
 	}
-	return Out;
+	StageSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, ResolutionIndex), static_cast<float>(Index));
+	StageSetting(GET_MEMBER_NAME_CHECKED(FPendingSettings, RefreshRate), static_cast<float>(Mode.RefreshRate));
+	bHasPendingChanges = true;
+	OnSettingsQueued.Broadcast();
 }
 
 TArray<FString> USettingsSubsystem::GetWindowModes() const
@@ -231,17 +1280,12 @@ TArray<FString> USettingsSubsystem::GetWindowModes() const
 
 int32 USettingsSubsystem::GetCurrentResolutionIndex() const
 {
-	auto* GS = GEngine->GetGameUserSettings();
-	FString Current = FString::Printf(TEXT("%d x %d"), GS->GetScreenResolution().X, GS->GetScreenResolution().Y);
-
-	auto StringList = GetAvailableResolutions();
-	return StringList.IndexOfByKey(Current);
+	return CurrentResolutionIndex;
 }
 
 int32 USettingsSubsystem::GetCurrentGraphics()
 {
-	auto* GS = GEngine->GetGameUserSettings();
-	return GS->GetOverallScalabilityLevel();
+	return GEngine->GetGameUserSettings()->GetOverallScalabilityLevel();
 }
 
 int32 USettingsSubsystem::GetCurrentWindowMode()
@@ -254,21 +1298,39 @@ int32 USettingsSubsystem::GetCurrentWindowMode()
 	}
 }
 
-FPendingSettings USettingsSubsystem::GetCurrentSettingsData() const
+const FPendingSettings& USettingsSubsystem::GetCurrentSettingsData() const
 {
-	if (PendingSettings.IsValid())
+	// SaveGame->Data is the authoritative in-memory copy, kept in step by ApplySettings.
+	// Anything queued but not applied yet is layered on top.
+	if (!bCurrentSettingsCached)
 	{
-		return PendingSettings;
+		const FUserSettingsData& Current = SaveGame ? SaveGame->Data : DefaultSettings;
+		CurrentSettingsCache = Current.MergedWith(PendingSettings).GetAsPendingSettings();
+		bCurrentSettingsCached = true;
 	}
-	
-	if (UGameplayStatics::DoesSaveGameExist("YenumUserSettings", 0))
+	return CurrentSettingsCache;
+}
+
+SIZE_T USettingsSubsystem::GetAllocatedBytes() const
+{
+	SIZE_T Bytes = sizeof(USettingsSubsystem) + DisplayModes.GetAllocatedSize();
+	if (SaveGame)
 	{
-		if (const auto* Save = Cast<USettingsSaveGame>(
-			UGameplayStatics::LoadGameFromSlot("YenumUserSettings", 0)))
-		{
-			return Save->Data.GetAsPendingSettings();
-		}
+		Bytes += SaveGame->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
 	}
-	
-	return DefaultSettings.GetAsPendingSettings();
+	Bytes += CustomSettings.GetAllocatedSize();
+	return Bytes;
+}
+
+int32 USettingsSubsystem::GetNumEventBindings() const
+{
+	return OnSettingsQueued.GetAllObjects().Num()
+		+ OnSettingsInitialized.GetAllObjects().Num()
+		+ OnSettingsApplied.GetAllObjects().Num()
+		+ OnSoundSettingsApplied.GetAllObjects().Num()
+		+ OnSettingsReverted.GetAllObjects().Num()
+		+ OnSettingsResetToDefaults.GetAllObjects().Num()
+		+ OnSettingsReady.GetAllObjects().Num()
+		+ OnSettingsPresetChanged.GetAllObjects().Num()
+		+ OnMemoryPressureChanged.GetAllObjects().Num();
 }
@@ -0,0 +1,128 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Performance/HardwareTier.h"
+
+#include "Tests/SSPCoreTests.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Tier rows with only the minimums a test is about; the rest are skipped (0)
+static FHardwareTierProfile Row(EHardwareTier Tier, int32 MinCores, int32 MinMemoryGB = 0, bool bAllowIntegratedGPU = true)
+{
+	FHardwareTierProfile Profile;
+	Profile.Tier = Tier;
+	Profile.MinCores = MinCores;
+	Profile.MinMemoryGB = MinMemoryGB;
+	Profile.bAllowIntegratedGPU = bAllowIntegratedGPU;
+	return Profile;
+}
+
+static FHardwareDescription Machine(int32 NumCores, int32 MemoryMB, bool bIntegratedGPU = false)
+{
+	FHardwareDescription Hardware;
+	Hardware.NumCores = NumCores;
+	Hardware.MemoryMB = MemoryMB;
+	Hardware.bIntegratedGPU = bIntegratedGPU;
+	return Hardware;
+}
+
+// Tier of the row Classify picks, Unknown for INDEX_NONE
+static EHardwareTier TierFor(const FHardwareDescription& Hardware, TConstArrayView<FHardwareTierProfile> Profiles)
+{
+	const int32 Index = HardwareTier::Classify(Hardware, Profiles);
+	return Profiles.IsValidIndex(Index) ? Profiles[Index].Tier : EHardwareTier::Unknown;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHardwareTierUnorderedTest, "SSPCore.HardwareTier.UnorderedRows", SSPCoreTests::Flags)
+bool FHardwareTierUnorderedTest::RunTest(const FString& Parameters)
+{
+	// Highest tier first and lowest in the middle: the pick goes by tier, not position
+	const TArray<FHardwareTierProfile> Profiles = {
+		Row(EHardwareTier::Epic, 8),
+		Row(EHardwareTier::Low, 0),
+		Row(EHardwareTier::High, 6),
+		Row(EHardwareTier::Medium, 4),
+	};
+	TestEqual(TEXT("Index of the High row"), HardwareTier::Classify(Machine(6, 16 * 1024), Profiles), 2);
+	TestTrue(TEXT("4 cores"), TierFor(Machine(4, 16 * 1024), Profiles) == EHardwareTier::Medium);
+	TestTrue(TEXT("16 cores"), TierFor(Machine(16, 16 * 1024), Profiles) == EHardwareTier::Epic);
+	TestTrue(TEXT("2 cores"), TierFor(Machine(2, 16 * 1024), Profiles) == EHardwareTier::Low);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHardwareTierUnreportedTest, "SSPCore.HardwareTier.UnreportedValuesFail", SSPCoreTests::Flags)
+bool FHardwareTierUnreportedTest::RunTest(const FString& Parameters)
+{
+	const TArray<FHardwareTierProfile>& Profiles = HardwareTier::GetBuiltInProfiles();
+
+	// Nothing reported: every row with a minimum fails, leaving the catch-all Low row
+	TestTrue(TEXT("Nothing reported"), TierFor(FHardwareDescription(), Profiles) == EHardwareTier::Low);
+
+	// Cores alone do not reach Medium, which also asks for a clock and memory
+	TestTrue(TEXT("Cores only"), TierFor(Machine(8, 0), Profiles) == EHardwareTier::Low);
+
+	// A row minimum of 0 skips the check for any machine
+	const TArray<FHardwareTierProfile> NoMemoryCheck = { Row(EHardwareTier::Low, 0), Row(EHardwareTier::High, 6, 0) };
+	TestTrue(TEXT("Row without a memory minimum"), TierFor(Machine(6, 1024), NoMemoryCheck) == EHardwareTier::High);
+	TestTrue(TEXT("Unreported memory against that row"), TierFor(Machine(6, 0), NoMemoryCheck) == EHardwareTier::High);
+
+	// Unreported video memory fails a video memory minimum
+	FHardwareTierProfile VideoRow = Row(EHardwareTier::High, 0);
+	VideoRow.MinVideoMemoryGB = 2;
+	const TArray<FHardwareTierProfile> VideoProfiles = { Row(EHardwareTier::Low, 0), VideoRow };
+	TestTrue(TEXT("No video memory reported"), TierFor(Machine(8, 32 * 1024), VideoProfiles) == EHardwareTier::Low);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHardwareTierIntegratedTest, "SSPCore.HardwareTier.IntegratedGPU", SSPCoreTests::Flags)
+bool FHardwareTierIntegratedTest::RunTest(const FString& Parameters)
+{
+	const TArray<FHardwareTierProfile> Profiles = {
+		Row(EHardwareTier::Low, 0),
+		Row(EHardwareTier::Medium, 4, 8, true),
+		Row(EHardwareTier::High, 6, 16, false),
+	};
+	TestTrue(TEXT("Discrete"), TierFor(Machine(8, 32 * 1024, false), Profiles) == EHardwareTier::High);
+	TestTrue(TEXT("Integrated falls to the best row allowing it"), TierFor(Machine(8, 32 * 1024, true), Profiles) == EHardwareTier::Medium);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHardwareTierRoundingTest, "SSPCore.HardwareTier.MemoryRounding", SSPCoreTests::Flags)
+bool FHardwareTierRoundingTest::RunTest(const FString& Parameters)
+{
+	const TArray<FHardwareTierProfile> Profiles = { Row(EHardwareTier::Low, 0), Row(EHardwareTier::High, 0, 16) };
+
+	// "16 GB" machines report less than 16384 MB once firmware and the iGPU take their share
+	TestTrue(TEXT("15.7 GB rounds up"), TierFor(Machine(0, 16 * 1024 - 300), Profiles) == EHardwareTier::High);
+	TestTrue(TEXT("Exactly 16 GB"), TierFor(Machine(0, 16 * 1024), Profiles) == EHardwareTier::High);
+	TestTrue(TEXT("15.4 GB rounds down"), TierFor(Machine(0, 15 * 1024 + 400), Profiles) == EHardwareTier::Low);
+
+	// Video memory goes through the same rounding
+	FHardwareTierProfile VideoRow = Row(EHardwareTier::High, 0);
+	VideoRow.MinVideoMemoryGB = 6;
+	const TArray<FHardwareTierProfile> VideoProfiles = { Row(EHardwareTier::Low, 0), VideoRow };
+	FHardwareDescription Hardware;
+	Hardware.VideoMemoryMB = 6 * 1024 - 200;
+	TestTrue(TEXT("5.8 GB video memory rounds up"), TierFor(Hardware, VideoProfiles) == EHardwareTier::High);
+	Hardware.VideoMemoryMB = 5 * 1024 + 400;
+	TestTrue(TEXT("5.4 GB video memory rounds down"), TierFor(Hardware, VideoProfiles) == EHardwareTier::Low);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHardwareTierFallbackTest, "SSPCore.HardwareTier.Fallback", SSPCoreTests::Flags)
+bool FHardwareTierFallbackTest::RunTest(const FString& Parameters)
+{
+	// No catch-all row: a machine below every row still gets the lowest tier in the table
+	const TArray<FHardwareTierProfile> Profiles = {
+		Row(EHardwareTier::High, 6),
+		Row(EHardwareTier::Medium, 4),
+		Row(EHardwareTier::Epic, 8),
+	};
+	TestEqual(TEXT("Below every row"), HardwareTier::Classify(Machine(2, 4 * 1024), Profiles), 1);
+
+	TestEqual(TEXT("Empty table"), HardwareTier::Classify(Machine(8, 32 * 1024), TConstArrayView<FHardwareTierProfile>()), INDEX_NONE);
+	return true;
+}
+
+#endif
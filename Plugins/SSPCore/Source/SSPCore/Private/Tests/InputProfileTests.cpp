@@ -0,0 +1,141 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/InputSettingsSubsystem.h"
+
+#include "Serialization/MemoryWriter.h"
+#include "Tests/SSPCoreTests.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// MappingName's Slot bound to Key; most tests only need the first slot
+static FBindingData Bind(FName MappingName, const FKey& Key, EPlayerMappableKeySlot Slot = EPlayerMappableKeySlot::First)
+{
+	FBindingData Binding;
+	Binding.MappingName = MappingName;
+	Binding.Slot = Slot;
+	Binding.Key = Key;
+	return Binding;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInputProfileRoundTripTest, "SSPCore.InputProfile.RoundTrip", SSPCoreTests::Flags)
+bool FInputProfileRoundTripTest::RunTest(const FString& Parameters)
+{
+	const TArray<FBindingData> Bindings = {
+		Bind(TEXT("Jump"), EKeys::SpaceBar),
+		Bind(TEXT("Fire"), EKeys::Gamepad_RightTrigger, EPlayerMappableKeySlot::Second),
+		// A slot cleared by a conflict
+		Bind(TEXT("Crouch"), EKeys::Invalid),
+	};
+	TArray<uint8> Bytes;
+	UInputSettingsSubsystem::SerializeProfile(Bindings, Bytes);
+
+	TArray<FBindingData> Read;
+	if (!TestTrue(TEXT("Deserialize"), UInputSettingsSubsystem::DeserializeProfile(Bytes, Read))
+		|| !TestEqual(TEXT("Num"), Read.Num(), Bindings.Num()))
+	{
+		return false;
+	}
+	for (int32 i = 0; i < Bindings.Num(); ++i)
+	{
+		TestEqual(TEXT("MappingName"), Read[i].MappingName, Bindings[i].MappingName);
+		TestTrue(TEXT("Slot"), Read[i].Slot == Bindings[i].Slot);
+		TestEqual(TEXT("Key"), Read[i].Key, Bindings[i].Key);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInputProfileVersion1Test, "SSPCore.InputProfile.ReadsVersion1", SSPCoreTests::Flags)
+bool FInputProfileVersion1Test::RunTest(const FString& Parameters)
+{
+	// Version 1 wrote a modifier byte after each key
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	uint32 Magic = 0x504E4959;
+	uint32 Version = 1;
+	int32 Num = 2;
+	Writer << Magic << Version << Num;
+	for (const TCHAR* Key : { TEXT("E"), TEXT("F") })
+	{
+		FString MappingName = TEXT("Interact");
+		uint8 Slot = 0;
+		FString KeyName = Key;
+		uint8 Modifiers = 1;
+		Writer << MappingName << Slot << KeyName << Modifiers;
+	}
+
+	TArray<FBindingData> Read;
+	if (!TestTrue(TEXT("Deserialize"), UInputSettingsSubsystem::DeserializeProfile(Bytes, Read))
+		|| !TestEqual(TEXT("Num"), Read.Num(), 2))
+	{
+		return false;
+	}
+	TestEqual(TEXT("First key"), Read[0].Key, EKeys::E);
+	TestEqual(TEXT("Second key, after the skipped modifiers"), Read[1].Key, EKeys::F);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInputProfileRejectsDamageTest, "SSPCore.InputProfile.RejectsDamagedFile", SSPCoreTests::Flags)
+bool FInputProfileRejectsDamageTest::RunTest(const FString& Parameters)
+{
+	const TArray<FBindingData> Bindings = {
+		Bind(TEXT("Jump"), EKeys::SpaceBar),
+		Bind(TEXT("Fire"), EKeys::LeftMouseButton),
+	};
+	TArray<uint8> Bytes;
+	UInputSettingsSubsystem::SerializeProfile(Bindings, Bytes);
+
+	TArray<FBindingData> Read;
+	TArray<uint8> Truncated(Bytes.GetData(), Bytes.Num() - 4);
+	TestFalse(TEXT("Truncated"), UInputSettingsSubsystem::DeserializeProfile(Truncated, Read));
+
+	TArray<uint8> WrongMagic = Bytes;
+	WrongMagic[0] ^= 0xFF;
+	TestFalse(TEXT("Wrong magic"), UInputSettingsSubsystem::DeserializeProfile(WrongMagic, Read));
+
+	TArray<uint8> Newer = Bytes;
+	Newer[4] = static_cast<uint8>(UInputSettingsSubsystem::ProfileVersion + 1);
+	TestFalse(TEXT("Newer version"), UInputSettingsSubsystem::DeserializeProfile(Newer, Read));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInputRebindSwapTest, "SSPCore.InputProfile.SwapDefaultKeys", SSPCoreTests::Flags)
+bool FInputRebindSwapTest::RunTest(const FString& Parameters)
+{
+	using FSlotId = UInputSettingsSubsystem::FSlotId;
+
+	// Both slots on their mapping defaults: in the index, not in the profile
+	const FBindingData Jump = Bind(TEXT("Jump"), EKeys::SpaceBar);
+	const FBindingData Crouch = Bind(TEXT("Crouch"), EKeys::C);
+	FInputKeyIndex Index;
+	Index.Add(Jump);
+	Index.Add(Crouch);
+	TMap<FSlotId, FBindingData> Overrides;
+	TMap<FSlotId, FKey> Mapped = {
+		{ FSlotId(Jump.MappingName, Jump.Slot), Jump.Key },
+		{ FSlotId(Crouch.MappingName, Crouch.Slot), Crouch.Key },
+	};
+
+	const TArray<FBindingData> Swap = {
+		Bind(TEXT("Jump"), EKeys::C),
+		Bind(TEXT("Crouch"), EKeys::SpaceBar),
+	};
+	const int32 NumBound = UInputSettingsSubsystem::ResolveRebinds(Swap, true, Index, Overrides, [&Mapped](const FBindingData& Binding)
+	{
+		Mapped.Add(FSlotId(Binding.MappingName, Binding.Slot), Binding.Key);
+		return true;
+	});
+
+	TestEqual(TEXT("Bound"), NumBound, 2);
+	TestEqual(TEXT("Jump mapped"), Mapped.FindRef(FSlotId(Jump.MappingName, Jump.Slot)), EKeys::C);
+	TestEqual(TEXT("Crouch mapped"), Mapped.FindRef(FSlotId(Crouch.MappingName, Crouch.Slot)), EKeys::SpaceBar);
+	const FBindingData* OnC = Index.FindByKey(EKeys::C);
+	const FBindingData* OnSpace = Index.FindByKey(EKeys::SpaceBar);
+	TestTrue(TEXT("C indexed to Jump"), OnC && OnC->MappingName == Jump.MappingName);
+	TestTrue(TEXT("Space indexed to Crouch"), OnSpace && OnSpace->MappingName == Crouch.MappingName);
+	TestEqual(TEXT("Profile Jump"), Overrides.FindRef(FSlotId(Jump.MappingName, Jump.Slot)).Key, EKeys::C);
+	TestEqual(TEXT("Profile Crouch"), Overrides.FindRef(FSlotId(Crouch.MappingName, Crouch.Slot)).Key, EKeys::SpaceBar);
+	return true;
+}
+
+#endif
@@ -0,0 +1,182 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Performance/QualityGovernor.h"
+
+#include "Tests/SSPCoreTests.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Short windows keep the traces readable: 10 frames per decision, 5 to settle
+static FQualityGovernorConfig MakeShortWindowConfig()
+{
+	FQualityGovernorConfig Config;
+	Config.TargetFrameMs = 16.f;
+	Config.WindowFrames = 10;
+	Config.SettleFrames = 5;
+	return Config;
+}
+
+static FQualityGovernor::FLevels UniformLevels(int32 Level)
+{
+	FQualityGovernor::FLevels Levels;
+	for (int32& Group : Levels)
+	{
+		Group = Level;
+	}
+	return Levels;
+}
+
+static FFrameTimeSample GPUBound(float Ms)
+{
+	FFrameTimeSample Sample;
+	Sample.GameMs = 5.f;
+	Sample.RenderMs = 5.f;
+	Sample.GPUMs = Ms;
+	return Sample;
+}
+
+struct FGovernorTrace
+{
+	TArray<FQualityGovernorDecision> Decisions;
+	// Frame (0-based within the trace) each decision was made on
+	TArray<int32> Frames;
+
+	// Feeds Sample NumFrames times and records every decision
+	static FGovernorTrace Run(FQualityGovernor& Governor, const FFrameTimeSample& Sample, int32 NumFrames)
+	{
+		FGovernorTrace Trace;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const FQualityGovernorDecision Decision = Governor.AddSample(Sample);
+			if (Decision.Action != EQualityGovernorAction::None)
+			{
+				Trace.Decisions.Add(Decision);
+				Trace.Frames.Add(Frame);
+			}
+		}
+		return Trace;
+	}
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQualityGovernorStepDownTest, "SSPCore.QualityGovernor.StepDownWhenOverBudget", SSPCoreTests::Flags)
+bool FQualityGovernorStepDownTest::RunTest(const FString& Parameters)
+{
+	FQualityGovernor Governor(MakeShortWindowConfig());
+	Governor.Reset(UniformLevels(3));
+
+	// One window at 25 ms against a 16 ms target
+	const FGovernorTrace Result = FGovernorTrace::Run(Governor, GPUBound(25.f), 10);
+	if (!TestEqual(TEXT("Decisions"), Result.Decisions.Num(), 1))
+	{
+		return false;
+	}
+	const FQualityGovernorDecision& Decision = Result.Decisions[0];
+	TestTrue(TEXT("Action"), Decision.Action == EQualityGovernorAction::StepDown);
+	TestTrue(TEXT("Group"), Decision.Group == FQualityGovernor::StepDownOrder[0]);
+	TestEqual(TEXT("NewLevel"), Decision.NewLevel, 2);
+	TestEqual(TEXT("Decided on the last frame of the window"), Result.Frames[0], 9);
+	TestEqual(TEXT("AverageMs"), Decision.AverageMs, 25.f);
+
+	// Steady overload keeps shedding, one group per window, in StepDownOrder
+	const FGovernorTrace More = FGovernorTrace::Run(Governor, GPUBound(25.f), 2 * (5 + 10));
+	if (TestEqual(TEXT("Further decisions"), More.Decisions.Num(), 2))
+	{
+		TestTrue(TEXT("Second group"), More.Decisions[0].Group == FQualityGovernor::StepDownOrder[1]);
+		TestTrue(TEXT("Third group"), More.Decisions[1].Group == FQualityGovernor::StepDownOrder[2]);
+	}
+
+	// Game-thread bound frames never step down, no group would help
+	FQualityGovernor GameBound(MakeShortWindowConfig());
+	GameBound.Reset(UniformLevels(3));
+	FFrameTimeSample Game;
+	Game.GameMs = 30.f;
+	Game.RenderMs = 10.f;
+	Game.GPUMs = 10.f;
+	TestEqual(TEXT("Game-bound decisions"), FGovernorTrace::Run(GameBound, Game, 100).Decisions.Num(), 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQualityGovernorHysteresisTest, "SSPCore.QualityGovernor.Hysteresis", SSPCoreTests::Flags)
+bool FQualityGovernorHysteresisTest::RunTest(const FString& Parameters)
+{
+	FQualityGovernor Governor(MakeShortWindowConfig());
+	Governor.Reset(UniformLevels(3));
+
+	// Between UpRatio (12.8 ms) and DownRatio (17.6 ms) nothing moves, either way
+	TestEqual(TEXT("Just under the down threshold"), FGovernorTrace::Run(Governor, GPUBound(17.f), 200).Decisions.Num(), 0);
+	TestEqual(TEXT("Just over the up threshold"), FGovernorTrace::Run(Governor, GPUBound(13.f), 200).Decisions.Num(), 0);
+
+	// A step down that lands the frame time in the dead band stays put: no up/down oscillation
+	FGovernorTrace::Run(Governor, GPUBound(20.f), 10);
+	TestEqual(TEXT("Stepped down"), Governor.GetLevels()[static_cast<int32>(FQualityGovernor::StepDownOrder[0])], 2);
+	TestEqual(TEXT("Dead band after the step"), FGovernorTrace::Run(Governor, GPUBound(15.f), 500).Decisions.Num(), 0);
+
+	// A trace alternating around the target averages inside the band
+	int32 Decisions = 0;
+	for (int32 Frame = 0; Frame < 500; ++Frame)
+	{
+		const float Ms = (Frame % 2) ? 19.f : 12.f;
+		Decisions += Governor.AddSample(GPUBound(Ms)).Action != EQualityGovernorAction::None;
+	}
+	TestEqual(TEXT("Alternating trace"), Decisions, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQualityGovernorRecoveryTest, "SSPCore.QualityGovernor.RecoveryStepsUpToCeiling", SSPCoreTests::Flags)
+bool FQualityGovernorRecoveryTest::RunTest(const FString& Parameters)
+{
+	FQualityGovernor Governor(MakeShortWindowConfig());
+	Governor.Reset(UniformLevels(3));
+
+	// Three windows over budget shed three groups
+	FGovernorTrace::Run(Governor, GPUBound(25.f), 10 + 2 * (5 + 10));
+	for (int32 i = 0; i < 3; ++i)
+	{
+		TestEqual(TEXT("Shed group"), Governor.GetLevels()[static_cast<int32>(FQualityGovernor::StepDownOrder[i])], 2);
+	}
+
+	// Headroom restores them in reverse order, then stops at the user's choice
+	const FGovernorTrace Result = FGovernorTrace::Run(Governor, GPUBound(8.f), 20 * (5 + 10));
+	if (TestEqual(TEXT("Step ups"), Result.Decisions.Num(), 3))
+	{
+		for (int32 i = 0; i < 3; ++i)
+		{
+			TestTrue(TEXT("Action"), Result.Decisions[i].Action == EQualityGovernorAction::StepUp);
+			TestTrue(TEXT("Reverse order"), Result.Decisions[i].Group == FQualityGovernor::StepDownOrder[2 - i]);
+			TestEqual(TEXT("NewLevel"), Result.Decisions[i].NewLevel, 3);
+		}
+	}
+	for (int32 Group = 0; Group < ScalabilityGroup::Num; ++Group)
+	{
+		TestEqual(TEXT("Back at the ceiling"), Governor.GetLevels()[Group], Governor.GetCeiling()[Group]);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQualityGovernorCooldownTest, "SSPCore.QualityGovernor.Cooldown", SSPCoreTests::Flags)
+bool FQualityGovernorCooldownTest::RunTest(const FString& Parameters)
+{
+	FQualityGovernor Governor(MakeShortWindowConfig());
+	Governor.Reset(UniformLevels(3));
+
+	// After a step the next SettleFrames samples are ignored, then a full window is needed
+	const FGovernorTrace Result = FGovernorTrace::Run(Governor, GPUBound(25.f), 10 + 5 + 10);
+	if (TestEqual(TEXT("Decisions"), Result.Decisions.Num(), 2))
+	{
+		TestEqual(TEXT("First step"), Result.Frames[0], 9);
+		TestEqual(TEXT("Second step waits for settle and window"), Result.Frames[1], 9 + 5 + 10);
+	}
+
+	// Samples during the settle period do not count towards the next window: a spike
+	// there followed by a calm window decides on the calm frames only
+	FQualityGovernor Spiky(MakeShortWindowConfig());
+	Spiky.Reset(UniformLevels(3));
+	FGovernorTrace::Run(Spiky, GPUBound(25.f), 10);
+	FGovernorTrace::Run(Spiky, GPUBound(100.f), 5);
+	const FGovernorTrace Calm = FGovernorTrace::Run(Spiky, GPUBound(15.f), 10);
+	TestEqual(TEXT("Settle spike ignored"), Calm.Decisions.Num(), 0);
+	return true;
+}
+
+#endif
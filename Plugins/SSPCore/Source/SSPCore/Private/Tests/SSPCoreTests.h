@@ -0,0 +1,49 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SSPCoreTests
+{
+	/** Unit tests: no world or RHI, so they run in every application context */
+	constexpr EAutomationTestFlags Flags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+	/** Tests that start a game instance, which needs a game engine: not in commandlets or on servers */
+	constexpr EAutomationTestFlags GameFlags = EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter;
+
+	/** Puts a CVar's value and set-by priority back when it goes out of scope */
+	class FScopedCVarRestore
+	{
+	public:
+		explicit FScopedCVarRestore(IConsoleVariable* InVariable)
+			: Variable(InVariable)
+		{
+			if (Variable)
+			{
+				Value = Variable->GetString();
+				SetBy = static_cast<EConsoleVariableFlags>(Variable->GetFlags() & ECVF_SetByMask);
+			}
+		}
+		~FScopedCVarRestore()
+		{
+			if (Variable)
+			{
+				// Set ignores a priority below the current one, so the priority is lowered first
+				Variable->SetFlags(static_cast<EConsoleVariableFlags>((Variable->GetFlags() & ~ECVF_SetByMask) | SetBy));
+				Variable->Set(*Value, SetBy);
+			}
+		}
+		UE_NONCOPYABLE(FScopedCVarRestore);
+
+	private:
+		IConsoleVariable* Variable = nullptr;
+		FString Value;
+		EConsoleVariableFlags SetBy = ECVF_SetByConstructor;
+	};
+}
+
+#endif
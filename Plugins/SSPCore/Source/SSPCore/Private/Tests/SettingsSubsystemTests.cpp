@@ -0,0 +1,259 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/SettingsSubsystem.h"
+
+#include "CVars/SettingsCVars.h"
+#include "Data/SettingsSaveGame.h"
+#include "Data/SettingsSchema.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "FuntionLibrary/GeneralSettingsBFL.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Persistence/SettingsPersistence.h"
+#include "Scalability.h"
+#include "Tests/SSPCoreTests.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// USettingsSubsystem driven through a standalone game instance, so queue, apply, revert and
+// reset run the real code down to the CVars and the save. Run with -nullrhi on a build
+// machine; nothing here needs a window.
+
+/**
+ * A game instance with its own settings subsystem. Snapshot and startup display writes go to
+ * scratch files under Saved/Automation, the settings the test changed are applied back before
+ * shutdown, and r.ToneMapperGamma gets its value and priority back.
+ */
+class FSettingsSubsystemFixture
+{
+public:
+	bool Start(FAutomationTestBase& Test)
+	{
+		if (!GEngine)
+		{
+			Test.AddError(TEXT("No engine to start a game instance in"));
+			return false;
+		}
+		RestoreGamma = MakeUnique<SSPCoreTests::FScopedCVarRestore>(SettingsCVars::Get(ESettingsCVar::ToneMapperGamma));
+		GameInstance = NewObject<UGameInstance>(GEngine);
+		GameInstance->AddToRoot();
+		GameInstance->InitializeStandalone();
+		Settings = GameInstance->GetSubsystem<USettingsSubsystem>();
+		if (!Settings)
+		{
+			Test.AddError(TEXT("The game instance has no settings subsystem"));
+			return false;
+		}
+		// Before the slot finishes loading, so the first apply already lands here
+		ScratchDir = FPaths::AutomationTransientDir() / TEXT("SSPCoreSettings");
+		Settings->ReplacePersistence(MakeUnique<FSettingsPersistence>(ScratchDir / TEXT("Settings.settings")));
+		Settings->ReplaceStartupDisplayStore(MakeUnique<FSettingsPersistence>(ScratchDir / TEXT("Display.settings")));
+		StartSeconds = FPlatformTime::Seconds();
+		return true;
+	}
+
+	// Latent: done once the slot is loaded and applied, or after a timeout reported on Test
+	bool WaitUntilReady(FAutomationTestBase& Test)
+	{
+		if (Settings && Settings->IsSettingsReady())
+		{
+			if (!bReady)
+			{
+				bReady = true;
+				Original = Settings->GetSaveGame()->Data;
+			}
+			return true;
+		}
+		if (!Settings || FPlatformTime::Seconds() - StartSeconds > ReadyTimeoutSeconds)
+		{
+			Test.AddError(TEXT("Settings did not become ready"));
+			return true;
+		}
+		return false;
+	}
+
+	void Stop()
+	{
+		if (bReady)
+		{
+			// The groups carry the overall level, Custom included
+			Settings->RevertPendingSettings();
+			const FSettingsSchema& Schema = FSettingsSchema::Get();
+			for (int32 i = 0; i < Schema.NumBuiltIn(); ++i)
+			{
+				if (Schema[i].Field != ESettingsField::GraphicsQuality)
+				{
+					Settings->QueueSetting(Schema[i].Key, Schema.ReadUser(i, Original));
+				}
+			}
+			Settings->ApplySettings();
+		}
+		if (GameInstance)
+		{
+			UWorld* World = GameInstance->GetWorld();
+			GameInstance->Shutdown();
+			GameInstance->RemoveFromRoot();
+			if (World)
+			{
+				GEngine->DestroyWorldContext(World);
+				World->DestroyWorld(false);
+			}
+		}
+		GameInstance = nullptr;
+		Settings = nullptr;
+		bReady = false;
+		RestoreGamma.Reset();
+		if (!ScratchDir.IsEmpty())
+		{
+			IFileManager::Get().DeleteDirectory(*ScratchDir, false, true);
+		}
+	}
+
+	bool IsReady() const { return bReady; }
+	USettingsSubsystem& GetSettings() const { return *Settings; }
+	UWorld* GetWorld() const { return GameInstance->GetWorld(); }
+	// Snapshot writes that reached the scratch file so far
+	uint32 FlushWrites() const
+	{
+		FSettingsPersistence* Persistence = Settings->GetPersistence();
+		Persistence->Flush();
+		return Persistence->GetNumWrites();
+	}
+
+private:
+	static constexpr double ReadyTimeoutSeconds = 10.0;
+
+	UGameInstance* GameInstance = nullptr;
+	USettingsSubsystem* Settings = nullptr;
+	bool bReady = false;
+	double StartSeconds = 0.0;
+	FString ScratchDir;
+	FUserSettingsData Original;
+	TUniquePtr<SSPCoreTests::FScopedCVarRestore> RestoreGamma;
+};
+
+// Starts Fixture and queues the latent steps: wait until ready, run Body, stop
+static bool RunWithSettingsSubsystem(FAutomationTestBase& Test, TFunction<void(FSettingsSubsystemFixture&)> Body)
+{
+	const TSharedRef<FSettingsSubsystemFixture> Fixture = MakeShared<FSettingsSubsystemFixture>();
+	if (!Fixture->Start(Test))
+	{
+		Fixture->Stop();
+		return false;
+	}
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([&Test, Fixture] { return Fixture->WaitUntilReady(Test); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([Fixture, Body = MoveTemp(Body)]
+	{
+		if (Fixture->IsReady())
+		{
+			Body(*Fixture);
+		}
+		return true;
+	}));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([Fixture]
+	{
+		Fixture->Stop();
+		return true;
+	}));
+	return true;
+}
+
+// r.ToneMapperGamma takes a GameSetting write unless something of higher priority holds it
+static bool IsGammaSettable()
+{
+	const IConsoleVariable* Gamma = SettingsCVars::Get(ESettingsCVar::ToneMapperGamma);
+	return Gamma && (Gamma->GetFlags() & ECVF_SetByMask) <= ECVF_SetByGameSetting;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSettingsSubsystemApplyTest, "SSPCore.Settings.Subsystem.QueueApply", SSPCoreTests::GameFlags)
+bool FSettingsSubsystemApplyTest::RunTest(const FString& Parameters)
+{
+	return RunWithSettingsSubsystem(*this, [this](FSettingsSubsystemFixture& Fixture)
+	{
+		USettingsSubsystem& Sub = Fixture.GetSettings();
+		const FName BrightnessKey = GET_MEMBER_NAME_CHECKED(FPendingSettings, Brightness);
+		const float SavedBrightness = Sub.GetSaveGame()->Data.Brightness;
+		const float Brightness = SavedBrightness == 2.f ? 1.5f : 2.f;
+		const float GammaBefore = SettingsCVars::GetFloat(ESettingsCVar::ToneMapperGamma, 0.f);
+		const bool bGammaSettable = IsGammaSettable();
+
+		// Queued: visible to queries, nowhere else
+		Sub.QueueBrightness(Brightness);
+		TestTrue(TEXT("Pending"), Sub.HasPendingChanges());
+		TestEqual(TEXT("Query sees the queued value"), Sub.GetSettingValue(BrightnessKey), Brightness);
+		TestEqual(TEXT("Save untouched"), Sub.GetSaveGame()->Data.Brightness, SavedBrightness);
+		TestEqual(TEXT("CVar untouched"), SettingsCVars::GetFloat(ESettingsCVar::ToneMapperGamma, 0.f), GammaBefore);
+
+		const uint32 WritesBefore = Fixture.FlushWrites();
+		Sub.ApplySettings();
+		TestFalse(TEXT("Queue cleared"), Sub.HasPendingChanges());
+		TestTrue(TEXT("Pushes only the queued field"), Sub.GetLastAppliedFields() == ESettingsField::Brightness);
+		TestEqual(TEXT("Saved"), Sub.GetSaveGame()->Data.Brightness, Brightness);
+		TestEqual(TEXT("One snapshot write"), static_cast<int32>(Fixture.FlushWrites() - WritesBefore), 1);
+		if (bGammaSettable)
+		{
+			TestEqual(TEXT("Gamma CVar"), SettingsCVars::GetFloat(ESettingsCVar::ToneMapperGamma, 0.f), Brightness);
+		}
+
+		// Nothing queued: the engine and the disk are left alone. A gamma held above GameSetting
+		// is retried on every apply, but never written again.
+		Sub.ApplySettings();
+		const ESettingsField Retried = bGammaSettable ? ESettingsField::None : ESettingsField::Brightness;
+		TestTrue(TEXT("Second apply pushes nothing new"), Sub.GetLastAppliedFields() == Retried);
+		TestEqual(TEXT("Second apply writes nothing"), static_cast<int32>(Fixture.FlushWrites() - WritesBefore), 1);
+
+		// The Blueprint nodes reach the same subsystem through the world
+		UWorld* World = Fixture.GetWorld();
+		const int32 ShadowLevel = Sub.GetSaveGame()->Data.TextureQuality == 0 ? 1 : 0;
+		UGeneralSettingsBFL::UpdateScalabilityGroup(World, EScalabilityGroup::Shadows, ShadowLevel);
+		TestEqual(TEXT("Queued group"), UGeneralSettingsBFL::GetScalabilityGroupLevel(World, EScalabilityGroup::Shadows), ShadowLevel);
+		TestTrue(TEXT("Groups differ"), UGeneralSettingsBFL::IsCustomGraphicsQuality(World));
+		UGeneralSettingsBFL::SaveSettings(World);
+		TestEqual(TEXT("Saved group"), Sub.GetSaveGame()->Data.ShadowQuality, ShadowLevel);
+		TestEqual(TEXT("Saved as Custom"), Sub.GetSaveGame()->Data.GraphicsQuality, -1);
+		TestEqual(TEXT("sg.ShadowQuality"), Scalability::GetQualityLevels().ShadowQuality, ShadowLevel);
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSettingsSubsystemRevertTest, "SSPCore.Settings.Subsystem.RevertReset", SSPCoreTests::GameFlags)
+bool FSettingsSubsystemRevertTest::RunTest(const FString& Parameters)
+{
+	return RunWithSettingsSubsystem(*this, [this](FSettingsSubsystemFixture& Fixture)
+	{
+		USettingsSubsystem& Sub = Fixture.GetSettings();
+		UWorld* World = Fixture.GetWorld();
+		const FName BrightnessKey = GET_MEMBER_NAME_CHECKED(FPendingSettings, Brightness);
+		const FUserSettingsData Saved = Sub.GetSaveGame()->Data;
+		const float GammaBefore = SettingsCVars::GetFloat(ESettingsCVar::ToneMapperGamma, 0.f);
+
+		// A previewed queue is rolled back and dropped
+		UGeneralSettingsBFL::UpdateBrightnessSettings(World, Saved.Brightness == 2.f ? 1.5f : 2.f);
+		Sub.QueueScalabilityGroup(EScalabilityGroup::Textures, Saved.TextureQuality == 0 ? 1 : 0);
+		UGeneralSettingsBFL::PreviewSettings(World);
+		Sub.RevertPendingSettings();
+		TestFalse(TEXT("Queue dropped"), Sub.HasPendingChanges());
+		TestEqual(TEXT("Query back to saved"), Sub.GetSettingValue(BrightnessKey), Saved.Brightness);
+		TestEqual(TEXT("Group back to saved"), UGeneralSettingsBFL::GetScalabilityGroupLevel(World, EScalabilityGroup::Textures), Saved.TextureQuality);
+		TestEqual(TEXT("Preview rolled back"), SettingsCVars::GetFloat(ESettingsCVar::ToneMapperGamma, 0.f), GammaBefore);
+		TestTrue(TEXT("Save untouched"), Sub.GetSaveGame()->Data.Diff(Saved) == ESettingsField::None);
+
+		// Reset lands on this machine's defaults and applies them in one go
+		UGeneralSettingsBFL::ResetSettingsToDefault(World);
+		const FUserSettingsData Defaults = UGeneralSettingsBFL::GetDefaultSettingsData(World);
+		TestFalse(TEXT("Nothing left queued"), Sub.HasPendingChanges());
+		// Display fields and volumes are reset to this monitor and the audio channel table, not to Defaults
+		const ESettingsField ResetFields = ESettingsField::Performance | ESettingsField::Brightness | ESettingsField::LatencyMode;
+		TestTrue(TEXT("Saved defaults"), (Sub.GetSaveGame()->Data.Diff(Defaults) & ResetFields) == ESettingsField::None);
+		TestEqual(TEXT("Queries see the defaults"), UGeneralSettingsBFL::GetSettingValue(World, BrightnessKey), Defaults.Brightness);
+		TestEqual(TEXT("sg.TextureQuality"), Scalability::GetQualityLevels().TextureQuality, Defaults.TextureQuality);
+		if (IsGammaSettable())
+		{
+			TestEqual(TEXT("Gamma CVar"), SettingsCVars::GetFloat(ESettingsCVar::ToneMapperGamma, 0.f), FMath::Clamp(Defaults.Brightness, 0.5f, 3.0f));
+		}
+	});
+}
+
+#endif
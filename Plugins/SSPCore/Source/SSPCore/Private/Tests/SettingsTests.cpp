@@ -0,0 +1,172 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Data/SettingsSaveGame.h"
+
+#include "CVars/SettingsCVars.h"
+#include "Data/SettingsSchema.h"
+#include "Tests/SSPCoreTests.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// The queue, apply and revert rules of USettingsSubsystem on plain data: queued values are
+// written into FPendingSettings through the schema, an apply merges them over the saved data
+// and pushes only the Diff against what is applied, a revert drops them.
+// SettingsSubsystemTests.cpp runs the same paths through a live subsystem.
+
+// What a fresh save resolves to once loaded
+static FUserSettingsData MakeSavedSettings()
+{
+	FUserSettingsData Saved = FUserSettingsData().MergedWith(FPendingSettings());
+	Saved.ClampPerformanceFields();
+	return Saved;
+}
+
+// USettingsSubsystem::StageSetting for a built-in setting
+static void QueueBuiltIn(FPendingSettings& Pending, const TCHAR* Key, float Value)
+{
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	const int32 Index = Schema.IndexOf(Key);
+	check(Index != INDEX_NONE && Schema[Index].IsBuiltIn());
+	Schema.WritePending(Index, Pending, Schema[Index].Sanitize(Value));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSettingsQueueTest, "SSPCore.Settings.Queue", SSPCoreTests::Flags)
+bool FSettingsQueueTest::RunTest(const FString& Parameters)
+{
+	const FUserSettingsData Saved = MakeSavedSettings();
+
+	FPendingSettings Pending;
+	TestFalse(TEXT("Nothing queued"), Pending.IsValid());
+	QueueBuiltIn(Pending, TEXT("Brightness"), 9.f);
+	TestTrue(TEXT("Queued"), Pending.IsValid());
+	TestEqual(TEXT("Clamped to the schema range"), Pending.Brightness, 3.f);
+
+	// Only the queued field moves
+	const FUserSettingsData Target = Saved.MergedWith(Pending);
+	TestTrue(TEXT("Diff is the queued field"), Target.Diff(Saved) == ESettingsField::Brightness);
+
+	// An overall level moves every group; a group queued on top makes it Custom
+	FPendingSettings Graphics;
+	QueueBuiltIn(Graphics, TEXT("GraphicsQuality"), 1.f);
+	const FUserSettingsData Uniform = Saved.MergedWith(Graphics);
+	TestEqual(TEXT("Overall level"), Uniform.GraphicsQuality, 1);
+	TestEqual(TEXT("Group follows"), Uniform.ShadowQuality, 1);
+	QueueBuiltIn(Graphics, TEXT("ShadowQuality"), 3.f);
+	const FUserSettingsData Custom = Saved.MergedWith(Graphics);
+	TestEqual(TEXT("Custom"), Custom.GraphicsQuality, -1);
+	TestEqual(TEXT("Queued group"), Custom.ShadowQuality, 3);
+	TestEqual(TEXT("Other groups"), Custom.TextureQuality, 1);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSettingsMergedValueTest, "SSPCore.Settings.MergedValue", SSPCoreTests::Flags)
+bool FSettingsMergedValueTest::RunTest(const FString& Parameters)
+{
+	const FSettingsSchema& Schema = FSettingsSchema::Get();
+	FUserSettingsData Legacy = MakeSavedSettings();
+	Legacy.FoliageQuality = -1;
+
+	// The single-field read has to agree with the full merge for every queue shape
+	FPendingSettings Overall;
+	QueueBuiltIn(Overall, TEXT("GraphicsQuality"), 1.f);
+	FPendingSettings Mixed = Overall;
+	QueueBuiltIn(Mixed, TEXT("ShadowQuality"), 3.f);
+	QueueBuiltIn(Mixed, TEXT("Brightness"), 2.f);
+	FPendingSettings Group;
+	QueueBuiltIn(Group, TEXT("TextureQuality"), 0.f);
+
+	for (const FUserSettingsData& Saved : { MakeSavedSettings(), Legacy })
+	{
+		for (const FPendingSettings& Pending : { FPendingSettings(), Overall, Mixed, Group })
+		{
+			const FUserSettingsData Merged = Saved.MergedWith(Pending);
+			for (int32 i = 0; i < Schema.NumBuiltIn(); ++i)
+			{
+				TestEqual(*Schema[i].Key.ToString(), Saved.GetMergedValue(i, Pending), Schema.ReadUser(i, Merged));
+			}
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSettingsApplyTest, "SSPCore.Settings.Apply", SSPCoreTests::Flags)
+bool FSettingsApplyTest::RunTest(const FString& Parameters)
+{
+	FUserSettingsData Applied = MakeSavedSettings();
+
+	FPendingSettings Pending;
+	QueueBuiltIn(Pending, TEXT("Brightness"), Applied.Brightness + 0.5f);
+	QueueBuiltIn(Pending, TEXT("FrameRateLimit"), 120.f);
+	FUserSettingsData Target = Applied.MergedWith(Pending);
+	Target.ClampPerformanceFields();
+	TestTrue(TEXT("Pushes the queued fields"), Target.Diff(Applied) == (ESettingsField::Brightness | ESettingsField::FrameRateLimit));
+	Applied = Target;
+
+	// Applying the same values again pushes nothing and writes nothing
+	FUserSettingsData Again = Applied.MergedWith(Pending);
+	Again.ClampPerformanceFields();
+	TestTrue(TEXT("Second apply is a no-op"), Again.Diff(Applied) == ESettingsField::None);
+
+	// A refresh rate reaches the frame rate limiter, not the swapchain or the presets
+	FPendingSettings Rate;
+	QueueBuiltIn(Rate, TEXT("RefreshRate"), 60.f);
+	const ESettingsField RateDirty = Applied.MergedWith(Rate).Diff(Applied);
+	TestTrue(TEXT("Refresh rate bit"), RateDirty == ESettingsField::RefreshRate);
+	TestFalse(TEXT("No display change"), EnumHasAnyFlags(RateDirty, ESettingsField::Display | ESettingsField::Performance));
+
+	// Values the engine would reject are clamped before the diff
+	FUserSettingsData Wild = Applied;
+	Wild.ScreenPercentage = 500.f;
+	Wild.DynResMinScreenPercentage = 80.f;
+	Wild.DynResMaxScreenPercentage = 40.f;
+	Wild.ClampPerformanceFields();
+	TestEqual(TEXT("Screen percentage"), Wild.ScreenPercentage, 200.f);
+	TestEqual(TEXT("Dynamic resolution max follows min"), Wild.DynResMaxScreenPercentage, 80.f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSettingsRevertTest, "SSPCore.Settings.Revert", SSPCoreTests::Flags)
+bool FSettingsRevertTest::RunTest(const FString& Parameters)
+{
+	const FUserSettingsData Saved = MakeSavedSettings();
+
+	// Revert drops the queue: the next apply sees the saved values
+	FPendingSettings Pending;
+	QueueBuiltIn(Pending, TEXT("Brightness"), Saved.Brightness + 0.5f);
+	QueueBuiltIn(Pending, TEXT("WindowMode"), 0.f);
+	Pending.Reset();
+	TestFalse(TEXT("Queue empty"), Pending.IsValid());
+	TestTrue(TEXT("Nothing to apply"), Saved.MergedWith(Pending).Diff(Saved) == ESettingsField::None);
+
+	// Reset to Defaults queues every default, which lands back on them
+	FUserSettingsData Changed = Saved;
+	Changed.Brightness = 1.f;
+	Changed.ShadowQuality = 0;
+	Changed.LatencyMode = 2;
+	FUserSettingsData Reset = Changed.MergedWith(Saved.GetAsPendingSettings());
+	Reset.ClampPerformanceFields();
+	TestTrue(TEXT("Back to defaults"), Reset.Diff(Saved) == ESettingsField::None);
+
+	// A preview is rolled back to what was applied
+	IConsoleVariable* Gamma = SettingsCVars::Get(ESettingsCVar::ToneMapperGamma);
+	if (!Gamma)
+	{
+		AddInfo(TEXT("r.ToneMapperGamma is not registered, skipping the preview rollback"));
+		return true;
+	}
+	const SSPCoreTests::FScopedCVarRestore RestoreGamma(Gamma);
+	const float Before = Gamma->GetFloat();
+	FSettingsCVarTransaction Preview;
+	Preview.Stage(ESettingsCVar::ToneMapperGamma, Before + 0.5f);
+	Preview.Commit();
+	if (Preview.WasApplied(ESettingsCVar::ToneMapperGamma))
+	{
+		TestEqual(TEXT("Previewed"), Gamma->GetFloat(), Before + 0.5f);
+	}
+	Preview.Rollback();
+	TestEqual(TEXT("Rolled back"), Gamma->GetFloat(), Before);
+	return true;
+}
+
+#endif
@@ -0,0 +1,78 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+
+/** Console variables driven directly by settings */
+enum class ESettingsCVar : uint8
+{
+	ToneMapperGamma,
+	DynResMinScreenPercentage,
+	DynResMaxScreenPercentage,
+	DynResFrameTimeBudget,
+	OneFrameThreadLag,
+	GTSyncType,
+	SyncSlackMS,
+	MaxFrameLatency,
+	StreamingPoolSize,
+	StreamingPoolSizeForMeshes,
+
+	Num
+};
+
+namespace SettingsCVars
+{
+	/**
+	 * Handle for CVar, looked up by name the first time it is found and cached after that.
+	 * Null if the owning module has not registered it yet. Game thread only.
+	 */
+	SSPCORE_API IConsoleVariable* Get(ESettingsCVar CVar);
+	SSPCORE_API const TCHAR* GetName(ESettingsCVar CVar);
+	SSPCORE_API float GetFloat(ESettingsCVar CVar, float Fallback);
+}
+
+/**
+ * A batch of CVar writes committed together, with the previous values kept for Rollback.
+ * Needs no world and never goes through the console string parser.
+ */
+class SSPCORE_API FSettingsCVarTransaction
+{
+public:
+	/** Queues Value for CVar; staging the same CVar twice keeps the last value */
+	void Stage(ESettingsCVar CVar, float Value);
+
+	/**
+	 * Writes every staged value at SetBy priority. A CVar already set at a higher priority
+	 * (ini, command line, console) keeps its value, is logged and reports !WasApplied.
+	 */
+	void Commit(EConsoleVariableFlags SetBy = ECVF_SetByGameSetting);
+
+	/** Restores the values captured by Commit, at the same priority */
+	void Rollback();
+
+	/** Forgets staged values and the rollback state */
+	void Reset();
+
+	/**
+	 * After Commit: false if CVar was staged but is not at the staged value, because it is
+	 * not registered or is held at a higher priority. True for CVars that were not staged.
+	 */
+	bool WasApplied(ESettingsCVar CVar) const;
+
+	bool IsEmpty() const { return Entries.Num() == 0; }
+	bool IsCommitted() const { return bCommitted; }
+
+private:
+	struct FEntry
+	{
+		ESettingsCVar CVar;
+		float Value;
+		float Previous;
+		bool bApplied;
+	};
+	TArray<FEntry, TInlineAllocator<static_cast<int32>(ESettingsCVar::Num)>> Entries;
+	EConsoleVariableFlags CommittedSetBy = ECVF_SetByGameSetting;
+	bool bCommitted = false;
+};
@@ -6,35 +6,112 @@
 #include "UObject/Object.h"
 #include "PendingSettings.generated.h"
 
+// Audio channels that predate the channel table and keep their own fields
+namespace SettingsAudioChannels
+{
+	SSPCORE_API extern const FName Master;
+	SSPCORE_API extern const FName SFX;
+	SSPCORE_API extern const FName Dialogue;
+}
+
 USTRUCT(BlueprintType)
-struct FPendingSettings
+struct SSPCORE_API FPendingSettings
 {
 	GENERATED_BODY()
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int32 GraphicsQuality = -1;
+	// Per-group overrides, layered on top of GraphicsQuality
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 ViewDistanceQuality = -1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 AntiAliasingQuality = -1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 ShadowQuality = -1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 GlobalIlluminationQuality = -1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 ReflectionQuality = -1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 PostProcessQuality = -1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 TextureQuality = -1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 EffectsQuality = -1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 FoliageQuality = -1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 ShadingQuality = -1;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float MasterVolume = -1.f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float SFXVolume = -1.f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float DialogueVolume = -1.f;
+	// Channels other than Master/SFX/Dialogue, by channel name
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TMap<FName, float> ChannelVolumes;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float Brightness = -1.f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int32 ResolutionIndex = -1;
+	// Hz, 0 = whatever the driver picks
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 RefreshRate = -1;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int32 WindowMode = -1;
+	// Frames per second, 0 = uncapped
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float FrameRateLimit = -1.f;
+	// 0 = off, 1 = on
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 VSync = -1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ScreenPercentage = -1.f;
+	// 0 = off, 1 = on
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 DynamicResolution = -1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float DynResMinScreenPercentage = -1.f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float DynResMaxScreenPercentage = -1.f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float DynResFrameTimeBudgetMs = -1.f;
+	// 0 = off, 1 = on, 2 = boost
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 LatencyMode = -1;
+	// MB, 0 = engine default
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Memory")
+	int32 TexturePoolSizeMB = -1;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Memory")
+	int32 MeshPoolSizeMB = -1;
 	/** Returns true if at least one setting has been modified */
-	bool IsValid() const
+	bool IsValid() const;
+
+	bool HasScalabilityGroupChanges() const
+	{
+		return ViewDistanceQuality >= 0 || AntiAliasingQuality >= 0 || ShadowQuality >= 0
+			|| GlobalIlluminationQuality >= 0 || ReflectionQuality >= 0 || PostProcessQuality >= 0
+			|| TextureQuality >= 0 || EffectsQuality >= 0 || FoliageQuality >= 0 || ShadingQuality >= 0;
+	}
+
+	/** Queues Volume for Channel, using the legacy field for Master/SFX/Dialogue */
+	void SetChannelVolume(FName Channel, float Volume)
+	{
+		if (Channel == SettingsAudioChannels::Master) MasterVolume = Volume;
+		else if (Channel == SettingsAudioChannels::SFX) SFXVolume = Volume;
+		else if (Channel == SettingsAudioChannels::Dialogue) DialogueVolume = Volume;
+		else ChannelVolumes.Add(Channel, Volume);
+	}
+
+	/** Queued volume of Channel, or -1 if none is queued */
+	float GetChannelVolume(FName Channel) const
 	{
-		return GraphicsQuality >= 0
-			|| Brightness >= 0.0f
-			|| MasterVolume >= 0.0f
-			|| SFXVolume >= 0.0f
-			|| DialogueVolume >= 0.0f
-			|| ResolutionIndex >= 0
-			|| WindowMode >= 0;
+		if (Channel == SettingsAudioChannels::Master) return MasterVolume;
+		if (Channel == SettingsAudioChannels::SFX) return SFXVolume;
+		if (Channel == SettingsAudioChannels::Dialogue) return DialogueVolume;
+		const float* Volume = ChannelVolumes.Find(Channel);
+		return Volume ? *Volume : -1.f;
 	}
 
 	/** Resets all values back to "unset" */
@@ -0,0 +1,54 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ScalabilityGroup.generated.h"
+
+/** Individually adjustable scalability groups (sg.*) */
+UENUM(BlueprintType)
+enum class EScalabilityGroup : uint8
+{
+	ViewDistance		UMETA(DisplayName = "View Distance"),
+	AntiAliasing		UMETA(DisplayName = "Anti-Aliasing"),
+	Shadows				UMETA(DisplayName = "Shadows"),
+	GlobalIllumination	UMETA(DisplayName = "Global Illumination"),
+	Reflections			UMETA(DisplayName = "Reflections"),
+	PostProcess			UMETA(DisplayName = "Post Process"),
+	Textures			UMETA(DisplayName = "Textures"),
+	Effects				UMETA(DisplayName = "Effects"),
+	Foliage				UMETA(DisplayName = "Foliage"),
+	Shading				UMETA(DisplayName = "Shading"),
+
+	Num					UMETA(Hidden)
+};
+
+namespace ScalabilityGroup
+{
+	constexpr int32 Num = static_cast<int32>(EScalabilityGroup::Num);
+
+	/**
+	 * The level field that backs Group. Works on anything using the engine's field names:
+	 * Scalability::FQualityLevels, FPendingSettings and FUserSettingsData.
+	 */
+	template<typename TLevels>
+	auto& Level(TLevels& Levels, EScalabilityGroup Group)
+	{
+		switch (Group)
+		{
+		case EScalabilityGroup::ViewDistance:		return Levels.ViewDistanceQuality;
+		case EScalabilityGroup::AntiAliasing:		return Levels.AntiAliasingQuality;
+		case EScalabilityGroup::Shadows:			return Levels.ShadowQuality;
+		case EScalabilityGroup::GlobalIllumination:	return Levels.GlobalIlluminationQuality;
+		case EScalabilityGroup::Reflections:		return Levels.ReflectionQuality;
+		case EScalabilityGroup::PostProcess:		return Levels.PostProcessQuality;
+		case EScalabilityGroup::Textures:			return Levels.TextureQuality;
+		case EScalabilityGroup::Effects:			return Levels.EffectsQuality;
+		case EScalabilityGroup::Foliage:			return Levels.FoliageQuality;
+		case EScalabilityGroup::Shading:			return Levels.ShadingQuality;
+		default:
+			checkNoEntry();
+			return Levels.ShadingQuality;
+		}
+	}
+}
@@ -0,0 +1,33 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Data/SettingsSaveGame.h"
+#include "SettingsPreset.generated.h"
+
+/**
+ * Named performance preset ("Battery Saver", "Competitive", "Quality", "Streaming"...).
+ * Only the performance fields of Settings are used: scalability, screen percentage,
+ * frame rate cap, VSync and dynamic resolution. Display mode, brightness and volumes
+ * stay as the player set them.
+ */
+UCLASS(BlueprintType)
+class SSPCORE_API USettingsPreset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	FName PresetID;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	FText DisplayName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	FUserSettingsData Settings;
+
+	/** Settings with groups resolved and values clamped, as ApplySettings would run them */
+	FUserSettingsData GetResolvedSettings() const;
+};
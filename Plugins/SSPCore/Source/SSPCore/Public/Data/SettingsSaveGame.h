@@ -4,17 +4,134 @@
 
 #include "CoreMinimal.h"
 #include "PendingSettings.h"
+#include "ScalabilityGroup.h"
+#include "Performance/HardwareTier.h"
 #include "GameFramework/SaveGame.h"
 #include "SettingsSaveGame.generated.h"
 
+// One bit per field of FUserSettingsData, used to re-apply only what changed
+enum class ESettingsField : uint32
+{
+	None			= 0,
+	GraphicsQuality	= 1 << 0,
+	Brightness		= 1 << 1,
+	MasterVolume	= 1 << 2,
+	SFXVolume		= 1 << 3,
+	DialogueVolume	= 1 << 4,
+	WindowMode		= 1 << 5,
+	ResolutionIndex	= 1 << 6,
+	FrameRateLimit	= 1 << 7,
+	VSync			= 1 << 8,
+	ScreenPercentage	= 1 << 9,
+	DynamicResolution	= 1 << 10,
+	DynResMinScreenPercentage	= 1 << 11,
+	DynResMaxScreenPercentage	= 1 << 12,
+	DynResFrameTimeBudgetMs		= 1 << 13,
+	ViewDistanceQuality	= 1 << 14,
+	AntiAliasingQuality	= 1 << 15,
+	ShadowQuality	= 1 << 16,
+	GlobalIlluminationQuality	= 1 << 17,
+	ReflectionQuality	= 1 << 18,
+	PostProcessQuality	= 1 << 19,
+	TextureQuality	= 1 << 20,
+	EffectsQuality	= 1 << 21,
+	FoliageQuality	= 1 << 22,
+	ShadingQuality	= 1 << 23,
+	ChannelVolumes	= 1 << 24,
+	LatencyMode		= 1 << 25,
+	TexturePoolSize	= 1 << 26,
+	MeshPoolSize	= 1 << 27,
+	RefreshRate		= 1 << 28,
+
+	Display			= WindowMode | ResolutionIndex,
+	Volumes			= MasterVolume | SFXVolume | DialogueVolume | ChannelVolumes,
+	ScalabilityGroups	= ViewDistanceQuality | AntiAliasingQuality | ShadowQuality | GlobalIlluminationQuality
+						| ReflectionQuality | PostProcessQuality | TextureQuality | EffectsQuality | FoliageQuality | ShadingQuality,
+	// Everything UGameUserSettings::ApplyNonResolutionSettings pushes in one go
+	NonResolution	= GraphicsQuality | ScalabilityGroups | FrameRateLimit | VSync | ScreenPercentage | DynamicResolution,
+	DynResBudget	= DynResMinScreenPercentage | DynResMaxScreenPercentage | DynResFrameTimeBudgetMs,
+	// Sized for the machine, so presets leave them alone
+	MemoryBudgets	= TexturePoolSize | MeshPoolSize,
+	// What a USettingsPreset controls
+	Performance		= NonResolution | DynResBudget
+};
+ENUM_CLASS_FLAGS(ESettingsField);
+
+namespace ScalabilityGroup
+{
+	/** Bit of Group's level; the group bits follow EScalabilityGroup order from ViewDistanceQuality */
+	constexpr ESettingsField Field(EScalabilityGroup Group)
+	{
+		return static_cast<ESettingsField>(static_cast<uint32>(ESettingsField::ViewDistanceQuality) << static_cast<uint32>(Group));
+	}
+}
+static_assert(ScalabilityGroup::Field(EScalabilityGroup::ViewDistance) == ESettingsField::ViewDistanceQuality
+	&& ScalabilityGroup::Field(EScalabilityGroup::AntiAliasing) == ESettingsField::AntiAliasingQuality
+	&& ScalabilityGroup::Field(EScalabilityGroup::Shadows) == ESettingsField::ShadowQuality
+	&& ScalabilityGroup::Field(EScalabilityGroup::GlobalIllumination) == ESettingsField::GlobalIlluminationQuality
+	&& ScalabilityGroup::Field(EScalabilityGroup::Reflections) == ESettingsField::ReflectionQuality
+	&& ScalabilityGroup::Field(EScalabilityGroup::PostProcess) == ESettingsField::PostProcessQuality
+	&& ScalabilityGroup::Field(EScalabilityGroup::Textures) == ESettingsField::TextureQuality
+	&& ScalabilityGroup::Field(EScalabilityGroup::Effects) == ESettingsField::EffectsQuality
+	&& ScalabilityGroup::Field(EScalabilityGroup::Foliage) == ESettingsField::FoliageQuality
+	&& ScalabilityGroup::Field(EScalabilityGroup::Shading) == ESettingsField::ShadingQuality,
+	"ESettingsField group bits must follow EScalabilityGroup order");
+static_assert(ScalabilityGroup::Num == 10, "New scalability group: add its ESettingsField bit and extend the assert above");
+
+/** How far the engine may pipeline frames; lower latency costs throughput */
+UENUM(BlueprintType)
+enum class ELatencyMode : uint8
+{
+	// Engine / project pipelining
+	Off,
+	// Game thread waits on the RHI thread, at most two frames queued
+	On,
+	// No game/render thread overlap, game thread paced to the swapchain flip, one frame queued
+	Boost
+};
+
 USTRUCT(BlueprintType)
-struct FUserSettingsData
+struct SSPCORE_API FUserSettingsData
 {
 	GENERATED_BODY()
 
+	// Overall level; -1 (Custom) when the groups below are not all at one level
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int32 GraphicsQuality = 2;
 
+	// Per-group levels. -1 follows GraphicsQuality, which is also how saves from before
+	// per-group settings load.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 ViewDistanceQuality = -1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 AntiAliasingQuality = -1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 ShadowQuality = -1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 GlobalIlluminationQuality = -1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 ReflectionQuality = -1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 PostProcessQuality = -1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 TextureQuality = -1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 EffectsQuality = -1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 FoliageQuality = -1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Scalability")
+	int32 ShadingQuality = -1;
+
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float Brightness = 2.0f;
 
@@ -26,6 +143,10 @@ struct FUserSettingsData
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float DialogueVolume = 0.5f;
+
+	// Volumes of the other channels in the audio channel table; missing ones use the table default
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TMap<FName, float> ChannelVolumes;
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int32 WindowMode = 1;
@@ -33,18 +154,117 @@ struct FUserSettingsData
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int32 ResolutionIndex = 0;
 
-	FPendingSettings GetAsPendingSettings() const
+	// Size at ResolutionIndex. The index is only valid for the mode list it was picked from,
+	// so loading re-finds it from this; zero in saves from before it was stored.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FIntPoint Resolution = FIntPoint::ZeroValue;
+
+	// Hz of the chosen display mode, 0 = whatever the driver picks
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 RefreshRate = 0;
+
+	// Frames per second, 0 = uncapped
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float FrameRateLimit = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bVSync = false;
+
+	// Fixed render resolution scale, used while dynamic resolution is off
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ScreenPercentage = 100.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bDynamicResolution = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float DynResMinScreenPercentage = 50.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float DynResMaxScreenPercentage = 100.0f;
+
+	// GPU time dynamic resolution scales to fit
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float DynResFrameTimeBudgetMs = 1000.0f / 60.0f;
+
+	// ELatencyMode; kept as an int so the settings schema can read and write it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 LatencyMode = 0;
+
+	// Texture streaming pool in MB, 0 = engine / project default. Set from installed memory on first run.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Memory")
+	int32 TexturePoolSizeMB = 0;
+
+	// Mesh streaming pool in MB, 0 = engine / project default (normally shared with textures)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Memory")
+	int32 MeshPoolSizeMB = 0;
+
+	// Field-by-field work below walks FSettingsSchema, so a new scalar setting only needs
+	// its fields here and in FPendingSettings plus one line in the schema table.
+	FPendingSettings GetAsPendingSettings() const;
+
+	/**
+	 * Copy of this data with every field set in Pending (>= 0) taken from Pending.
+	 * A pending overall level resets every group, pending group levels go on top, then
+	 * GraphicsQuality is recomputed so it reads -1 (Custom) when the groups diverge.
+	 */
+	FUserSettingsData MergedWith(const FPendingSettings& Pending) const;
+
+	/**
+	 * Built-in setting Index as MergedWith(Pending) would hold it, without building the copy,
+	 * so single-field queries never copy ChannelVolumes.
+	 */
+	float GetMergedValue(int32 Index, const FPendingSettings& Pending) const;
+	/** Group's level as MergedWith(Pending) would hold it */
+	int32 GetMergedScalabilityLevel(EScalabilityGroup Group, const FPendingSettings& Pending) const;
+
+	/** Fields whose values differ between this and Other */
+	ESettingsField Diff(const FUserSettingsData& Other) const;
+
+	/** Volume of Channel, or Default if it has never been set */
+	float GetChannelVolume(FName Channel, float Default) const
+	{
+		if (Channel == SettingsAudioChannels::Master) return MasterVolume;
+		if (Channel == SettingsAudioChannels::SFX) return SFXVolume;
+		if (Channel == SettingsAudioChannels::Dialogue) return DialogueVolume;
+		const float* Volume = ChannelVolumes.Find(Channel);
+		return Volume ? *Volume : Default;
+	}
+
+	/** Level shared by every group, or -1 (Custom) if they differ */
+	int32 GetUniformScalabilityLevel() const
 	{
-		FPendingSettings PendingData;
-		PendingData.GraphicsQuality = GraphicsQuality;
-		PendingData.Brightness = Brightness;
-		PendingData.MasterVolume = MasterVolume;
-		PendingData.SFXVolume = SFXVolume;
-		PendingData.DialogueVolume = DialogueVolume;
-		PendingData.WindowMode = WindowMode;
-		PendingData.ResolutionIndex = ResolutionIndex;
-		return PendingData;
-	};
+		const int32 First = ScalabilityGroup::Level(*this, static_cast<EScalabilityGroup>(0));
+		for (int32 i = 1; i < ScalabilityGroup::Num; ++i)
+		{
+			if (ScalabilityGroup::Level(*this, static_cast<EScalabilityGroup>(i)) != First)
+			{
+				return -1;
+			}
+		}
+		return First;
+	}
+
+	bool IsCustomScalability() const { return GetUniformScalabilityLevel() < 0; }
+
+	/** Clamps the performance fields into ranges the engine accepts */
+	void ClampPerformanceFields()
+	{
+		for (int32 i = 0; i < ScalabilityGroup::Num; ++i)
+		{
+			int32& Level = ScalabilityGroup::Level(*this, static_cast<EScalabilityGroup>(i));
+			Level = FMath::Clamp(Level, 0, 4);
+		}
+		GraphicsQuality = GetUniformScalabilityLevel();
+		FrameRateLimit = FMath::Max(FrameRateLimit, 0.0f);
+		ScreenPercentage = FMath::Clamp(ScreenPercentage, 10.0f, 200.0f);
+		DynResMinScreenPercentage = FMath::Clamp(DynResMinScreenPercentage, 10.0f, 100.0f);
+		DynResMaxScreenPercentage = FMath::Clamp(DynResMaxScreenPercentage, DynResMinScreenPercentage, 200.0f);
+		DynResFrameTimeBudgetMs = FMath::Max(DynResFrameTimeBudgetMs, 1.0f);
+		LatencyMode = FMath::Clamp(LatencyMode, 0, static_cast<int32>(ELatencyMode::Boost));
+		TexturePoolSizeMB = FMath::Clamp(TexturePoolSizeMB, 0, 16384);
+		MeshPoolSizeMB = FMath::Clamp(MeshPoolSizeMB, 0, 8192);
+	}
 };
 /**
  * 
@@ -54,8 +274,21 @@ class SSPCORE_API USettingsSaveGame : public USaveGame
 {
 	GENERATED_BODY()
 public:
+	USettingsSaveGame();
+
+	// Save objects constructed since startup, excluding the CDO. Read by ssp.MemReport.
+	static uint32 GetNumCreated();
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FUserSettingsData Data;
 
+	// Settings registered with FSettingsSchema at runtime, by key
+	UPROPERTY()
+	TMap<FName, float> CustomSettings;
+
+	// Classified on first run and kept, so new drivers or hardware never move the defaults
+	UPROPERTY()
+	EHardwareTier HardwareTier = EHardwareTier::Unknown;
+
 	void SaveData(const FPendingSettings& PendingSettingsData);
 };
@@ -0,0 +1,129 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+
+struct FPendingSettings;
+struct FUserSettingsData;
+enum class ESettingsField : uint32;
+
+enum class ESettingValueType : uint8
+{
+	Int,
+	Float,
+	Bool
+};
+
+/** Everything the settings system knows about one setting */
+struct SSPCORE_API FSettingDescriptor
+{
+	// Also the FPendingSettings field name for built-in settings
+	FName Key;
+	ESettingValueType Type = ESettingValueType::Float;
+	float Min = 0.0f;
+	float Max = 1.0f;
+	float Default = 0.0f;
+	// Bit ApplySettings batches a built-in setting under; None for registered settings
+	ESettingsField Field = {};
+	// Runs when a registered setting's value is applied. Built-in settings are applied by
+	// USettingsSubsystem::ApplySettings so their engine work can be batched.
+	TFunction<void(float)> Applier;
+
+	// Bound fields, null for registered settings
+	const FProperty* UserProperty = nullptr;
+	const FProperty* PendingProperty = nullptr;
+
+	bool IsBuiltIn() const { return UserProperty != nullptr; }
+	/** Value clamped to the range, rounded for Int and Bool */
+	float Sanitize(float Value) const;
+};
+
+/**
+ * Registry of every setting. Built-in settings are bound to the fields of FUserSettingsData
+ * and FPendingSettings by reflection; their types and defaults come from the fields, and
+ * merge, diff and preset copies walk this table rather than the fields. They stay typed
+ * struct fields because saves, Blueprints and preset assets use them by name, so a new
+ * built-in needs a field in both structs plus a row in GBuiltInSettings (checked at startup).
+ *
+ * Games can register more through Register, which only need a key, range, default and
+ * applier; those live in FSettingsValues. Lookup by key is a single hash.
+ */
+class SSPCORE_API FSettingsSchema
+{
+public:
+	static FSettingsSchema& Get();
+
+	/** Adds a setting with no struct field. Call before the game instance starts. Returns its index. */
+	int32 Register(FSettingDescriptor Descriptor);
+
+	int32 IndexOf(FName Key) const
+	{
+		const int32* Index = KeyToIndex.Find(Key);
+		return Index ? *Index : INDEX_NONE;
+	}
+	const FSettingDescriptor* Find(FName Key) const
+	{
+		const int32 Index = IndexOf(Key);
+		return Index != INDEX_NONE ? &Descriptors[Index] : nullptr;
+	}
+	const FSettingDescriptor& operator[](int32 Index) const { return Descriptors[Index]; }
+	int32 Num() const { return Descriptors.Num(); }
+	// Built-in settings occupy indices [0, NumBuiltIn)
+	int32 NumBuiltIn() const { return BuiltInCount; }
+
+	// Field access for built-in settings. Pending values below 0 mean "not queued".
+	float ReadUser(int32 Index, const FUserSettingsData& Data) const;
+	void WriteUser(int32 Index, FUserSettingsData& Data, float Value) const;
+	float ReadPending(int32 Index, const FPendingSettings& Pending) const;
+	void WritePending(int32 Index, FPendingSettings& Pending, float Value) const;
+
+private:
+	FSettingsSchema();
+
+	TArray<FSettingDescriptor> Descriptors;
+	TMap<FName, int32> KeyToIndex;
+	int32 BuiltInCount = 0;
+};
+
+/**
+ * Compact storage for registered settings: one float per schema entry and a dirty bit.
+ * Built-in entries are unused here, their values live in the settings structs.
+ * Persisted by key, so adding or removing settings never invalidates a save.
+ */
+class SSPCORE_API FSettingsValues
+{
+public:
+	/** Every setting at its default, nothing dirty */
+	void Reset();
+	/** Sanitizes Value; marks the setting dirty and returns true if it changed */
+	bool Set(int32 Index, float Value);
+	float Get(int32 Index) const;
+
+	bool IsDirty(int32 Index) const { return Dirty.IsValidIndex(Index) && Dirty[Index]; }
+	bool HasDirty() const { return Dirty.Find(true) != INDEX_NONE; }
+	void ClearDirty() { Dirty.Init(false, Dirty.Num()); }
+
+	template <typename FuncType>
+	void ForEachDirty(FuncType&& Func) const
+	{
+		for (TConstSetBitIterator<> It(Dirty); It; ++It)
+		{
+			Func(It.GetIndex(), Values[It.GetIndex()]);
+		}
+	}
+
+	/** Registered settings by key */
+	void SaveTo(TMap<FName, float>& Out) const;
+	/** Unknown keys are dropped, values sanitized; nothing dirty afterwards */
+	void LoadFrom(const TMap<FName, float>& In);
+
+	SIZE_T GetAllocatedSize() const { return Values.GetAllocatedSize() + Dirty.GetAllocatedSize(); }
+
+private:
+	void EnsureSize();
+
+	TArray<float> Values;
+	TBitArray<> Dirty;
+};
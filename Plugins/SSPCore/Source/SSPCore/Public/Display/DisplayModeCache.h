@@ -0,0 +1,95 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GenericPlatform/GenericApplication.h"
+#include "DisplayModeCache.generated.h"
+
+USTRUCT(BlueprintType)
+struct FSettingsDisplayMode
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 Width = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 Height = 0;
+
+	// Hz, 0 when the platform does not report it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 RefreshRate = 0;
+
+	FIntPoint GetResolution() const { return FIntPoint(Width, Height); }
+
+	bool operator==(const FSettingsDisplayMode& Other) const
+	{
+		return Width == Other.Width && Height == Other.Height && RefreshRate == Other.RefreshRate;
+	}
+
+	friend uint32 GetTypeHash(const FSettingsDisplayMode& Mode)
+	{
+		return HashCombineFast(GetTypeHash(Mode.GetResolution()), GetTypeHash(Mode.RefreshRate));
+	}
+};
+
+USTRUCT(BlueprintType)
+struct FSettingsMonitor
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	FString Name;
+
+	UPROPERTY(BlueprintReadOnly)
+	FIntPoint NativeResolution = FIntPoint::ZeroValue;
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bIsPrimary = false;
+
+	// Desktop area of the monitor, for finding which one holds the window
+	FPlatformRect DisplayRect;
+};
+
+/**
+ * Display modes (size and refresh rate) and the connected monitors. Built once from the RHI
+ * and the platform display metrics, and rebuilt only when those metrics change.
+ * The RHI only enumerates the primary output, so there is one mode list for every monitor.
+ * Modes are sorted by width, height, then refresh rate; every query is an index or hash lookup.
+ */
+class SSPCORE_API FDisplayModeCache
+{
+public:
+	void Rebuild(const FDisplayMetrics& Metrics);
+
+	TConstArrayView<FSettingsDisplayMode> GetModes() const { return Modes; }
+	const TArray<FString>& GetModeLabels() const { return ModeLabels; }
+	int32 FindMode(const FSettingsDisplayMode& Mode) const;
+
+	// Distinct sizes across every mode; ResolutionIndex indexes this list
+	TConstArrayView<FIntPoint> GetResolutions() const { return Resolutions; }
+	const TArray<FString>& GetResolutionLabels() const { return ResolutionLabels; }
+	int32 FindResolution(const FIntPoint& Resolution) const;
+
+	/** Size at Index in the unsorted RHI order, which saves from before this cache indexed */
+	FIntPoint GetLegacyResolution(int32 Index) const;
+
+	TConstArrayView<FSettingsMonitor> GetMonitors() const { return Monitors; }
+	/** Monitor containing ScreenPoint, else the primary one, else INDEX_NONE */
+	int32 FindMonitor(const FIntPoint& ScreenPoint) const;
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	TArray<FSettingsDisplayMode> Modes;
+	TArray<FString> ModeLabels;
+	TMap<FSettingsDisplayMode, int32> ModeToIndex;
+
+	TArray<FIntPoint> Resolutions;
+	TArray<FString> ResolutionLabels;
+	TMap<FIntPoint, int32> ResolutionToIndex;
+	TArray<FIntPoint> LegacyResolutions;
+
+	TArray<FSettingsMonitor> Monitors;
+};
@@ -6,10 +6,19 @@
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "GeneralSettingsBFL.generated.h"
 
+struct FBindingData;
 struct FPendingSettings;
+struct FSettingsDisplayMode;
+struct FSettingsMemoryPressure;
+struct FSettingsMonitor;
 struct FUserSettingsData;
 enum class EVolumeType : uint8;
+enum class EScalabilityGroup : uint8;
+enum class ELatencyMode : uint8;
+enum class EHardwareTier : uint8;
+class UInputSettingsSubsystem;
 class USettingsSubsystem;
+class USettingsPreset;
 UENUM(BlueprintType)
 enum class EVisualSettingsType : uint8
 {
@@ -29,17 +38,59 @@ class SSPCORE_API UGeneralSettingsBFL : public UBlueprintFunctionLibrary
 
 public:
 	static USettingsSubsystem* GetSettingsSubsystem(const UObject* WorldContextObject);
+	static UInputSettingsSubsystem* GetInputSettingsSubsystem(const UObject* WorldContextObject);
 	// -------------------- Init --------------------
 	UFUNCTION(BlueprintCallable, Category="Yenum|Settings", meta=(WorldContext="WorldContextObject"))
 	static void InitSettings(const UObject* WorldContextObject, USoundMix* SoundMix);
+	UFUNCTION(BlueprintPure, Category="Yenum|Settings", meta=(WorldContext="WorldContextObject"))
+	static bool IsSettingsReady(const UObject* WorldContextObject);
 	// -------------------- Resolution --------------------
 	
 	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Display", meta=(WorldContext="WorldContextObject"))
 	static void UpdateVisualSettings(const UObject* WorldContextObject, EVisualSettingsType Type, int32 Level);
 	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Volume", meta=(WorldContext="WorldContextObject"))
 	static void UpdateVolumeSettings(const UObject* WorldContextObject, EVolumeType Type, float Level);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Volume", meta=(WorldContext="WorldContextObject"))
+	static void UpdateChannelVolume(const UObject* WorldContextObject, FName Channel, float Level);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Volume", meta=(WorldContext="WorldContextObject"))
+	static void PreviewChannelVolume(const UObject* WorldContextObject, FName Channel, float Level);
+	UFUNCTION(BlueprintPure, Category="Yenum|Settings|Volume", meta=(WorldContext="WorldContextObject"))
+	static float GetChannelVolume(const UObject* WorldContextObject, FName Channel);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Volume", meta=(WorldContext="WorldContextObject"))
+	static TArray<FName> GetAudioChannels(const UObject* WorldContextObject);
 	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Brightness", meta=(WorldContext="WorldContextObject"))
 	static void UpdateBrightnessSettings(const UObject* WorldContextObject, float Value);
+	// -------------------- Performance --------------------
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Performance", meta=(WorldContext="WorldContextObject"))
+	static void UpdateFrameRateLimit(const UObject* WorldContextObject, float FramesPerSecond);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Performance", meta=(WorldContext="WorldContextObject"))
+	static void UpdateVSync(const UObject* WorldContextObject, bool bEnabled);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Performance", meta=(WorldContext="WorldContextObject"))
+	static void UpdateScreenPercentage(const UObject* WorldContextObject, float Percentage);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Performance", meta=(WorldContext="WorldContextObject"))
+	static void UpdateDynamicResolution(const UObject* WorldContextObject, bool bEnabled, float MinScreenPercentage = 50.f, float MaxScreenPercentage = 100.f, float FrameTimeBudgetMs = 16.67f);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Performance", meta=(WorldContext="WorldContextObject"))
+	static void UpdateLatencyMode(const UObject* WorldContextObject, ELatencyMode Mode);
+	UFUNCTION(BlueprintPure, Category="Yenum|Settings|Performance", meta=(WorldContext="WorldContextObject"))
+	static ELatencyMode GetLatencyMode(const UObject* WorldContextObject);
+	// -------------------- Memory --------------------
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Memory", meta=(WorldContext="WorldContextObject"))
+	static void UpdateMemoryBudgets(const UObject* WorldContextObject, int32 TexturePoolSizeMB, int32 MeshPoolSizeMB = 0);
+	UFUNCTION(BlueprintPure, Category="Yenum|Settings|Memory", meta=(WorldContext="WorldContextObject"))
+	static FSettingsMemoryPressure GetMemoryPressure(const UObject* WorldContextObject);
+	UFUNCTION(BlueprintPure, Category="Yenum|Settings|Memory", meta=(WorldContext="WorldContextObject"))
+	static int32 GetTexturePoolLimit(const UObject* WorldContextObject);
+	UFUNCTION(BlueprintPure, Category="Yenum|Settings|Memory", meta=(WorldContext="WorldContextObject"))
+	static EHardwareTier GetHardwareTier(const UObject* WorldContextObject);
+	// -------------------- Presets --------------------
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Presets", meta=(WorldContext="WorldContextObject"))
+	static TArray<USettingsPreset*> GetSettingsPresets(const UObject* WorldContextObject);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Presets", meta=(WorldContext="WorldContextObject"))
+	static void ApplySettingsPreset(const UObject* WorldContextObject, USettingsPreset* Preset);
+	UFUNCTION(BlueprintPure, Category="Yenum|Settings|Presets", meta=(WorldContext="WorldContextObject"))
+	static USettingsPreset* GetActiveSettingsPreset(const UObject* WorldContextObject);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings", meta=(WorldContext="WorldContextObject"))
+	static void PreviewSettings(const UObject* WorldContextObject);
 	UFUNCTION(BlueprintCallable, Category="Yenum|Settings", meta=(WorldContext="WorldContextObject"))
 	static void SaveSettings(const UObject* WorldContextObject);
 	UFUNCTION(BlueprintCallable, Category="Yenum|Settings", meta=(WorldContext="WorldContextObject"))
@@ -50,10 +101,30 @@ public:
 	static TArray<FString> GetAvailableResolutions(const UObject* WorldContextObject);
 	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Display")
 	static TArray<FString> GetGraphics();
+
+	// -------------------- Scalability Groups --------------------
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Display", meta=(WorldContext="WorldContextObject"))
+	static void UpdateScalabilityGroup(const UObject* WorldContextObject, EScalabilityGroup Group, int32 Level);
+	UFUNCTION(BlueprintPure, Category="Yenum|Settings|Display", meta=(WorldContext="WorldContextObject"))
+	static int32 GetScalabilityGroupLevel(const UObject* WorldContextObject, EScalabilityGroup Group);
+	UFUNCTION(BlueprintPure, Category="Yenum|Settings|Display", meta=(WorldContext="WorldContextObject"))
+	static bool IsCustomGraphicsQuality(const UObject* WorldContextObject);
 	
 	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Display", meta=(WorldContext="WorldContextObject"))
 	static int32 GetCurrentResolutionIndex(const UObject* WorldContextObject);
 
+	// -------------------- Display Modes --------------------
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Display", meta=(WorldContext="WorldContextObject"))
+	static TArray<FSettingsMonitor> GetMonitors(const UObject* WorldContextObject);
+	UFUNCTION(BlueprintPure, Category="Yenum|Settings|Display", meta=(WorldContext="WorldContextObject"))
+	static int32 GetCurrentMonitor(const UObject* WorldContextObject);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Display", meta=(WorldContext="WorldContextObject"))
+	static TArray<FSettingsDisplayMode> GetDisplayModes(const UObject* WorldContextObject);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Display", meta=(WorldContext="WorldContextObject"))
+	static TArray<FString> GetDisplayModeLabels(const UObject* WorldContextObject);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Display", meta=(WorldContext="WorldContextObject"))
+	static void UpdateDisplayMode(const UObject* WorldContextObject, const FSettingsDisplayMode& Mode);
+
 	// -------------------- Window Mode --------------------
 
 	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Display")
@@ -63,8 +134,24 @@ public:
 	static int32 GetCurrentWindowMode();
 
 	
+	// -------------------- Input --------------------
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Input", meta=(WorldContext="WorldContextObject"))
+	static TArray<FBindingData> GetInputBindings(const UObject* WorldContextObject);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Input", meta=(WorldContext="WorldContextObject"))
+	static bool FindInputConflict(const UObject* WorldContextObject, const FBindingData& Binding, FBindingData& Conflict);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Input", meta=(WorldContext="WorldContextObject"))
+	static bool RebindInputKey(const UObject* WorldContextObject, const FBindingData& Binding, bool bClearConflicts = true);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Input", meta=(WorldContext="WorldContextObject"))
+	static int32 RebindInputKeys(const UObject* WorldContextObject, const TArray<FBindingData>& Bindings, bool bClearConflicts = true);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings|Input", meta=(WorldContext="WorldContextObject"))
+	static void ResetInputBindings(const UObject* WorldContextObject);
+
 	// -------------------- Data --------------------
 	UFUNCTION(BlueprintCallable, Category="Yenum|Settings", meta=(WorldContext="WorldContextObject"))
+	static void UpdateSetting(const UObject* WorldContextObject, FName Key, float Value);
+	UFUNCTION(BlueprintPure, Category="Yenum|Settings", meta=(WorldContext="WorldContextObject"))
+	static float GetSettingValue(const UObject* WorldContextObject, FName Key);
+	UFUNCTION(BlueprintCallable, Category="Yenum|Settings", meta=(WorldContext="WorldContextObject"))
 	static FUserSettingsData GetDefaultSettingsData(const UObject* WorldContextObject);
 	UFUNCTION(BlueprintCallable, Category="Yenum|Settings", meta=(WorldContext="WorldContextObject"))
 	static FPendingSettings GetPendingSettingsData(const UObject* WorldContextObject);
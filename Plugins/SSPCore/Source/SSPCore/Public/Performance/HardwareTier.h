@@ -0,0 +1,115 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HardwareTier.generated.h"
+
+class USettingsPreset;
+
+UENUM(BlueprintType)
+enum class EHardwareTier : uint8
+{
+	// Not classified yet, e.g. a save from before tiering
+	Unknown,
+	Low,
+	Medium,
+	High,
+	Epic
+};
+
+/** What the first-run tiering looks at. 0 means the platform did not report the value. */
+USTRUCT(BlueprintType)
+struct SSPCORE_API FHardwareDescription
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumCores = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumLogicalCores = 0;
+
+	// Nominal clock; Windows reports the base clock, Linux the maximum
+	UPROPERTY(BlueprintReadOnly)
+	int32 CpuClockMHz = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 MemoryMB = 0;
+
+	// Dedicated video memory; 0 on unified memory or without an RHI
+	UPROPERTY(BlueprintReadOnly)
+	int32 VideoMemoryMB = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bIntegratedGPU = false;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 GPUVendorId = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	FString AdapterName;
+
+	// GPU fields came from a real RHI; false without one or under -nullrhi
+	UPROPERTY(BlueprintReadOnly)
+	bool bHasRHI = false;
+};
+
+/**
+ * One row of the tier table, configured in DefaultGame.ini:
+ * [/Script/SSPCore.SettingsSubsystem]
+ * +HardwareTiers=(Tier=High,MinCores=6,MinMemoryGB=16,MinVideoMemoryGB=6,bAllowIntegratedGPU=False,Preset="/Game/Settings/DA_High.DA_High")
+ */
+USTRUCT(BlueprintType)
+struct SSPCORE_API FHardwareTierProfile
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	EHardwareTier Tier = EHardwareTier::Low;
+
+	// Minimums; 0 skips the check. A value the platform did not report fails any minimum,
+	// so a machine that cannot be described falls back to the lowest tier.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 MinCores = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 MinCpuClockMHz = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 MinMemoryGB = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 MinVideoMemoryGB = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	bool bAllowIntegratedGPU = true;
+
+	// Performance defaults for the tier. Without a preset only the overall level is set.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	TSoftObjectPtr<USettingsPreset> Preset;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 GraphicsQuality = 2;
+
+	bool IsMetBy(const FHardwareDescription& Hardware) const;
+};
+
+/**
+ * First-run hardware tiering. Classify is a pure function of the description so tier
+ * tables can be checked against made-up machines (see ssp.HardwareTier).
+ */
+namespace HardwareTier
+{
+	/** Describes this machine. GPU fields stay empty until the RHI is up. */
+	SSPCORE_API FHardwareDescription Describe();
+
+	/**
+	 * Index in Profiles of the highest tier Hardware meets. A machine below every row gets
+	 * the lowest tier; INDEX_NONE only when Profiles is empty. Rows may be in any order.
+	 */
+	SSPCORE_API int32 Classify(const FHardwareDescription& Hardware, TConstArrayView<FHardwareTierProfile> Profiles);
+
+	/** Used when the project configures no HardwareTiers */
+	SSPCORE_API const TArray<FHardwareTierProfile>& GetBuiltInProfiles();
+}
@@ -0,0 +1,148 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Input latency instrumentation. Compiled out of shipping builds unless the target defines
+// SSP_WITH_INPUT_LATENCY=1; even when compiled in it does nothing until ssp.InputLatency.Enable is set.
+#ifndef SSP_WITH_INPUT_LATENCY
+#define SSP_WITH_INPUT_LATENCY !UE_BUILD_SHIPPING
+#endif
+
+class UEnhancedInputComponent;
+class UInputAction;
+class UInputMappingContext;
+struct FEnhancedActionKeyMapping;
+
+#if SSP_WITH_INPUT_LATENCY
+
+#include "Containers/Queue.h"
+#include "InputCoreTypes.h"
+#include <atomic>
+
+enum class EInputLatencyStage : uint8
+{
+	// Slate receiving the key, button, axis or mouse move, to the Enhanced Input action starting
+	RawToTrigger,
+	// Action starting, to gameplay code reporting it handled the action
+	TriggerToConsume,
+	// Handled, to the frame that carries the result being presented
+	ConsumeToPresent,
+	RawToPresent,
+	Num
+};
+
+/** Fixed log-scale histogram of microseconds, written from any thread without locks */
+struct SSPCORE_API FLatencyHistogram
+{
+	// Bucket i holds samples up to 50us * 1.25^i, the last one reaching past 60 s
+	static constexpr int32 NumBuckets = 64;
+
+	void Add(double Microseconds);
+	/** Upper bound of the bucket holding the P-th percentile (0-1), 0 when empty */
+	double Percentile(double P) const;
+	uint32 GetCount() const { return Count.load(std::memory_order_relaxed); }
+	void Reset();
+
+	static double BucketUpperUs(int32 Bucket);
+
+private:
+	std::atomic<uint32> Buckets[NumBuckets] = {};
+	std::atomic<uint32> Count{ 0 };
+};
+
+/**
+ * Timestamps each bound action from raw input to presentation and aggregates the four
+ * stages per action. Raw receipt is when Slate processes the platform event, which is
+ * the earliest portable hook. A trigger with no input on its action's keys since the
+ * previous one (fired from code, or a key rebound after binding) is counted, not timed.
+ *
+ * UInputLatencySubsystem probes every action mapped for a local player. Game code may report
+ * consumption; actions that never report count as consumed when they trigger:
+ *
+ *     SSP_INPUT_CONSUMED(JumpAction);
+ *
+ * Input components outside the player's stack can be probed directly, before their own
+ * bindings so the trigger is stamped first:
+ *
+ *     FInputLatencyTracker::Get().BindProbes(EnhancedInputComponent, MappingContext);
+ */
+class SSPCORE_API FInputLatencyTracker
+{
+public:
+	static FInputLatencyTracker& Get();
+
+	/** Probes every action in Context on InputComponent */
+	void BindProbes(UEnhancedInputComponent* InputComponent, const UInputMappingContext* Context);
+	/** Probes the actions in Mappings that are not in Bound yet, and adds them to it. Keys are recorded for all. */
+	void BindProbes(UEnhancedInputComponent* InputComponent, TConstArrayView<FEnhancedActionKeyMapping> Mappings, TSet<const UInputAction*>& Bound);
+	void MarkConsumed(const UInputAction* Action);
+
+	void Report(FOutputDevice& Ar) const;
+	bool WriteCSV(const FString& Path) const;
+	void Reset();
+
+	static bool IsEnabled();
+
+	// Hooks into Slate and the renderer; run once at the end of engine init and on exit
+	void Startup();
+	void Shutdown();
+
+private:
+	friend class FLatencyInputProcessor;
+
+	struct FActionLatency
+	{
+		FName Name;
+		TArray<FKey> Keys;
+		FLatencyHistogram Stages[static_cast<int32>(EInputLatencyStage::Num)];
+		// Game thread only
+		uint32 NumUnmatched = 0;
+		uint64 LastTrigger = 0;
+		uint64 PendingRaw = 0;
+		uint64 PendingTrigger = 0;
+		uint64 PendingConsume = 0;
+		bool bPending = false;
+	};
+
+	struct FInFlightSample
+	{
+		FActionLatency* Action = nullptr;
+		uint64 Raw = 0;
+		uint64 Trigger = 0;
+		uint64 Consume = 0;
+		uint64 Frame = 0;
+	};
+
+	FInputLatencyTracker() = default;
+
+	FActionLatency& FindOrAddAction(const UInputAction* Action);
+	void OnRawInput(const FKey& Key);
+	void OnTriggered(FActionLatency& Action);
+	void OnEndFrame();
+	// Render thread, once per presented window
+	void OnPresent();
+
+	// Game thread. Entries are never removed, so the render thread can hold on to them.
+	TArray<TUniquePtr<FActionLatency>> Actions;
+	TMap<const UInputAction*, int32> ActionToIndex;
+	TMap<FKey, uint64> LastRawInput;
+	TArray<FActionLatency*> PendingActions;
+
+	// Game thread in, render thread out. Capped so nothing piles up without presents (-nullrhi).
+	TQueue<FInFlightSample, EQueueMode::Spsc> InFlight;
+	std::atomic<int32> NumInFlight{ 0 };
+
+	TSharedPtr<class IInputProcessor> InputProcessor;
+	FDelegateHandle EndFrameHandle;
+	FDelegateHandle PresentHandle;
+};
+
+#define SSP_INPUT_CONSUMED(Action) FInputLatencyTracker::Get().MarkConsumed(Action)
+
+#else
+
+#define SSP_INPUT_CONSUMED(Action)
+
+#endif
@@ -0,0 +1,56 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InputCoreTypes.h"
+
+enum class ERecordedInputType : uint8
+{
+	// Keyboard, gamepad and mouse buttons
+	KeyDown,
+	KeyUp,
+	// Gamepad sticks and triggers; X is the axis value
+	Analog,
+	// X/Y is the cursor delta in pixels
+	MouseMove,
+	// X is the wheel delta
+	MouseWheel
+};
+
+struct FRecordedInputEvent
+{
+	// Frames since the recording started
+	uint32 Frame = 0;
+	ERecordedInputType Type = ERecordedInputType::KeyDown;
+	// Index into FInputRecording::Keys; unused for mouse moves and the wheel
+	uint16 Key = 0;
+	float X = 0.f;
+	float Y = 0.f;
+};
+
+/**
+ * Raw input captured frame by frame at a fixed timestep, in a compact binary form:
+ * key names once in a table, then per event a packed frame delta, a type byte, a packed
+ * key index and only the values that type needs.
+ */
+struct SSPCORE_API FInputRecording
+{
+	float FixedDeltaTime = 1.f / 60.f;
+	// Random seed applied when recording and playback start
+	int32 Seed = 0;
+	// Length of the session; playback runs this long even if the last frames are idle
+	uint32 NumFrames = 0;
+	TArray<FKey> Keys;
+	// Ordered by frame
+	TArray<FRecordedInputEvent> Events;
+
+	void Reset();
+	uint16 FindOrAddKey(const FKey& Key);
+	void Add(uint32 Frame, ERecordedInputType Type, const FKey& Key, float X = 0.f, float Y = 0.f);
+
+	void Serialize(TArray<uint8>& OutBytes) const;
+	bool Deserialize(const TArray<uint8>& Bytes);
+	bool SaveToFile(const FString& Path) const;
+	bool LoadFromFile(const FString& Path);
+};
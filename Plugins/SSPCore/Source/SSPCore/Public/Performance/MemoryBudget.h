@@ -0,0 +1,58 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MemoryBudget.generated.h"
+
+/** Streaming pool state as last sampled by USettingsSubsystem, in MB */
+USTRUCT(BlueprintType)
+struct SSPCORE_API FSettingsMemoryPressure
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 PoolSizeMB = 0;
+
+	// How far the streamer wanted to go past the pool; 0 while within budget
+	UPROPERTY(BlueprintReadOnly)
+	int32 OverBudgetMB = 0;
+
+	// Most the streamer has wanted at once since the pool size last changed
+	UPROPERTY(BlueprintReadOnly)
+	int32 MaxEverRequiredMB = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bOverBudget = false;
+
+	// Pool size that would cover the demand, within what this machine can afford. 0 when within budget.
+	UPROPERTY(BlueprintReadOnly)
+	int32 RecommendedPoolSizeMB = 0;
+
+	// The recommendation hit the machine limit; lowering Texture quality is the remaining option
+	UPROPERTY(BlueprintReadOnly)
+	bool bAtMemoryLimit = false;
+
+	bool operator==(const FSettingsMemoryPressure& Other) const
+	{
+		return PoolSizeMB == Other.PoolSizeMB && bOverBudget == Other.bOverBudget
+			&& RecommendedPoolSizeMB == Other.RecommendedPoolSizeMB && bAtMemoryLimit == Other.bAtMemoryLimit;
+	}
+};
+
+/**
+ * Texture streaming pool sizing from installed memory. Pools are capped by both system
+ * RAM (the streamer stages through it) and dedicated video memory when the RHI reports it.
+ */
+namespace MemoryBudget
+{
+	/** Pool size for a first run on this machine */
+	SSPCORE_API int32 GetDefaultTexturePoolMB(uint64 PhysicalBytes, uint64 VideoBytes);
+	/** Largest pool this machine can afford */
+	SSPCORE_API int32 GetTexturePoolLimitMB(uint64 PhysicalBytes, uint64 VideoBytes);
+	/** Dedicated video memory, 0 when the RHI does not report it (e.g. unified memory, -nullrhi) */
+	SSPCORE_API uint64 GetVideoMemoryBytes();
+
+	/** Samples the streaming manager and derives a recommendation against LimitMB */
+	SSPCORE_API FSettingsMemoryPressure Sample(int32 LimitMB);
+}
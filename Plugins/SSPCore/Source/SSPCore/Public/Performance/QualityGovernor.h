@@ -0,0 +1,81 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "Data/ScalabilityGroup.h"
+
+/** One frame of timings, in milliseconds */
+struct FFrameTimeSample
+{
+	float GameMs = 0.f;
+	float RenderMs = 0.f;
+	float GPUMs = 0.f;
+};
+
+struct FQualityGovernorConfig
+{
+	float TargetFrameMs = 1000.f / 60.f;
+	// Step down when the window average is above Target * DownRatio
+	float DownRatio = 1.10f;
+	// Step up when the window average is below Target * UpRatio
+	float UpRatio = 0.80f;
+	// Frames averaged before any decision
+	int32 WindowFrames = 60;
+	// Frames ignored after a step so the new level settles before it is judged
+	int32 SettleFrames = 120;
+};
+
+enum class EQualityGovernorAction : uint8
+{
+	None,
+	StepDown,
+	StepUp
+};
+
+struct FQualityGovernorDecision
+{
+	EQualityGovernorAction Action = EQualityGovernorAction::None;
+	EScalabilityGroup Group = EScalabilityGroup::Num;
+	int32 NewLevel = 0;
+	float AverageMs = 0.f;
+};
+
+/**
+ * Frame-time driven scalability controller.
+ *
+ * Pure logic, no engine state: feed it samples, it returns at most one group change per
+ * decision window. Groups are shed in order of cost to visual impact and restored in the
+ * reverse order, never above the ceiling (the user's own choice). Being game-thread bound
+ * never triggers a step down since no scalability group would help.
+ */
+class SSPCORE_API FQualityGovernor
+{
+public:
+	using FLevels = TStaticArray<int32, ScalabilityGroup::Num>;
+
+	explicit FQualityGovernor(const FQualityGovernorConfig& InConfig = FQualityGovernorConfig());
+
+	/** Resets levels and ceiling to the user's choice and restarts the window */
+	void Reset(const FLevels& UserLevels);
+	void SetConfig(const FQualityGovernorConfig& InConfig) { Config = InConfig; }
+
+	FQualityGovernorDecision AddSample(const FFrameTimeSample& Sample);
+
+	const FLevels& GetLevels() const { return Levels; }
+	const FLevels& GetCeiling() const { return Ceiling; }
+
+	/** Order groups are stepped down in; step up walks it backwards */
+	static const EScalabilityGroup StepDownOrder[ScalabilityGroup::Num];
+
+private:
+	FQualityGovernorConfig Config;
+	FLevels Levels;
+	FLevels Ceiling;
+
+	double GameSum = 0.0;
+	double BoundSum = 0.0;
+	int32 WindowCount = 0;
+	int32 SettleRemaining = 0;
+};
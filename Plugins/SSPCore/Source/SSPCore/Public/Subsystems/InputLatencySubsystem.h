@@ -0,0 +1,36 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/LocalPlayerSubsystem.h"
+#include "InputLatencySubsystem.generated.h"
+
+class UEnhancedInputComponent;
+class UInputAction;
+
+/**
+ * Binds the input latency probes for a local player, whatever pawn it controls. Every action
+ * in the player's applied mapping contexts is probed on the player controller's input
+ * component, which Enhanced Input evaluates before the pawn's, so a trigger is stamped before
+ * gameplay reports consuming it. Created only when SSP_WITH_INPUT_LATENCY is compiled in.
+ */
+UCLASS()
+class SSPCORE_API UInputLatencySubsystem : public ULocalPlayerSubsystem
+{
+	GENERATED_BODY()
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	// Contexts are added and removed at runtime; each rebuild probes the actions new to the player
+	UFUNCTION()
+	void HandleControlMappingsRebuilt();
+
+	// Component the probes are bound on and the actions already probed there. A new player
+	// controller comes with a new component, which starts over.
+	TWeakObjectPtr<UEnhancedInputComponent> ProbedComponent;
+	TSet<const UInputAction*> ProbedActions;
+};
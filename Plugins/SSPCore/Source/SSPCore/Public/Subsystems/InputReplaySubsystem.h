@@ -0,0 +1,84 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Performance/InputRecording.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "InputReplaySubsystem.generated.h"
+
+class IInputProcessor;
+
+DECLARE_MULTICAST_DELEGATE(FOnInputPlaybackFinished);
+
+/**
+ * Records raw input to a file and plays it back through Slate for repeatable benchmark
+ * runs. Both run at a fixed timestep (ssp.InputReplay.FPS) from the same random seed, and
+ * playback blocks real input, so a recording drives the same frames on every build.
+ *
+ * Command line, started once the first map has loaded:
+ *     -SSPInputRecord=Path       record until exit or ssp.InputReplay.Stop
+ *     -SSPInputPlayback=Path     play back, e.g. with -nullrhi
+ *     -SSPInputPlaybackExit      quit when playback ends
+ * Relative paths resolve under Saved/InputRecordings.
+ */
+UCLASS()
+class SSPCORE_API UInputReplaySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	bool StartRecording(const FString& Path);
+	bool StartPlayback(const FString& Path);
+	/** Ends recording (writing the file) or playback (releasing held keys) */
+	void Stop();
+
+	bool IsRecording() const { return Mode == EMode::Recording; }
+	bool IsPlaying() const { return Mode == EMode::Playing; }
+	/** Frames since recording or playback started */
+	uint32 GetFrame() const { return Frame; }
+	const FInputRecording& GetRecording() const { return Recording; }
+
+	/** Fired on the game thread after the last recorded frame has been played */
+	FOnInputPlaybackFinished OnPlaybackFinished;
+
+	static FString ResolvePath(const FString& Path);
+
+private:
+	friend class FInputReplayProcessor;
+
+	enum class EMode : uint8
+	{
+		Idle,
+		Recording,
+		Playing
+	};
+
+	void HandlePostLoadMap(UWorld* World);
+	void Begin(EMode NewMode);
+	void OnBeginFrame();
+	void Inject(const FRecordedInputEvent& Event);
+	/** From the preprocessor: records while recording, swallows real input while playing */
+	bool HandleRawInput(ERecordedInputType Type, const FKey& Key, float X = 0.f, float Y = 0.f);
+	bool IsBlockingRealInput() const { return Mode == EMode::Playing && !bInjecting; }
+
+	FInputRecording Recording;
+	FString RecordingPath;
+	EMode Mode = EMode::Idle;
+	uint32 Frame = 0;
+	int32 NextEvent = 0;
+	// Set while injected events travel through Slate, so the preprocessor lets them pass
+	bool bInjecting = false;
+	bool bExitWhenFinished = false;
+	TSet<uint16> HeldKeys;
+
+	bool bSavedFixedTimeStep = false;
+	double SavedFixedDeltaTime = 0.0;
+
+	TSharedPtr<IInputProcessor> InputProcessor;
+	FDelegateHandle BeginFrameHandle;
+	FDelegateHandle PostLoadMapHandle;
+};
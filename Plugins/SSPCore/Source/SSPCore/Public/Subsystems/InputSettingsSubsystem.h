@@ -3,21 +3,124 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "InputCoreTypes.h"
+#include "Persistence/SettingsPersistence.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "Templates/Function.h"
+#include "UserSettings/EnhancedInputUserSettings.h"
 #include "InputSettingsSubsystem.generated.h"
 
+class ULocalPlayer;
+class UEnhancedInputLocalPlayerSubsystem;
 
+/**
+ * One player-mappable key slot: which mapping, which slot, and the key bound to it.
+ * Player mappings carry a single key, so modifier chords are not rebindable here.
+ */
 USTRUCT(BlueprintType)
 struct FBindingData
 {
 	GENERATED_BODY()
 
+	// Player mappable name of the action mapping (Player Mappable Key Settings → Name)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName MappingName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EPlayerMappableKeySlot Slot = EPlayerMappableKeySlot::First;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FKey Key;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnInputBindingsChanged);
+
+/**
+ * Key -> slot bound to it, and slot -> key, kept in step. The reverse map lets a rebind
+ * drop the slot's old key whether it came from the profile or the mapping defaults.
+ */
+struct SSPCORE_API FInputKeyIndex
+{
+	using FSlotId = TPair<FName, EPlayerMappableKeySlot>;
+
+	const FBindingData* FindByKey(const FKey& Key) const { return ByKey.Find(Key); }
+	/** Binds Binding's slot to its key, replacing what either was bound to before */
+	void Add(const FBindingData& Binding);
+	void RemoveSlot(const FSlotId& Slot);
+	void Reset();
+
+private:
+	TMap<FKey, FBindingData> ByKey;
+	TMap<FSlotId, FKey> BySlot;
 };
+
 /**
- * 
+ * Keyboard and gamepad rebinding on top of Enhanced Input player-mappable keys.
+ * Needs "Enable User Settings" in the Enhanced Input project settings.
+ *
+ * A hash index from key to slot keeps conflict checks constant-time however many
+ * actions there are. Rebinds in one call trigger a single mapping-context rebuild.
+ * Customized slots are saved in a small binary profile through FSettingsPersistence
+ * and re-applied once the first local player's input settings exist.
  */
 UCLASS()
 class SSPCORE_API UInputSettingsSubsystem : public UGameInstanceSubsystem
 {
 	GENERATED_BODY()
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Fired after bindings change, once per batch */
+	UPROPERTY(BlueprintAssignable, Category="Settings|Events")
+	FOnInputBindingsChanged OnInputBindingsChanged;
+
+	/** Every player-mappable slot of the active key profile */
+	TArray<FBindingData> GetBindings() const;
+	/** Slot already using Binding's key, other than Binding's own slot. O(1). */
+	bool FindConflict(const FBindingData& Binding, FBindingData& OutConflict) const;
+
+	/**
+	 * Binds every entry, then rebuilds mappings and saves once. A conflicting slot is
+	 * cleared when bClearConflicts is set, otherwise that entry is skipped.
+	 * Returns the number of entries bound.
+	 */
+	int32 RebindKeys(TConstArrayView<FBindingData> Bindings, bool bClearConflicts = true);
+	bool RebindKey(const FBindingData& Binding, bool bClearConflicts = true) { return RebindKeys(MakeArrayView(&Binding, 1), bClearConflicts) == 1; }
+	/** Restores every slot to its default key */
+	void ResetBindings();
+
+	using FSlotId = FInputKeyIndex::FSlotId;
+
+	/**
+	 * RebindKeys without Enhanced Input: resolves conflicts against Index, calls MapKey for
+	 * every slot to change (an invalid key clears the slot) and keeps Index and Overrides in
+	 * step with each entry MapKey accepts. Returns the number of entries bound.
+	 */
+	static int32 ResolveRebinds(TConstArrayView<FBindingData> Bindings, bool bClearConflicts, FInputKeyIndex& Index,
+		TMap<FSlotId, FBindingData>& Overrides, TFunctionRef<bool(const FBindingData&)> MapKey);
+
+	/** Profile file format version. Version 1 also stored modifier bits, which are skipped. */
+	static constexpr uint32 ProfileVersion = 2;
+	static void SerializeProfile(const TArray<FBindingData>& Bindings, TArray<uint8>& OutBytes);
+	static bool DeserializeProfile(const TArray<uint8>& Bytes, TArray<FBindingData>& OutBindings);
+
+private:
+	UEnhancedInputLocalPlayerSubsystem* GetInputSubsystem() const;
+	UEnhancedInputUserSettings* GetUserSettings() const;
+
+	FInputKeyIndex KeyIndex;
+	void RebuildIndex();
+
+	// Customized slots, what the profile file holds
+	TMap<FSlotId, FBindingData> Overrides;
+	bool bProfileLoaded = false;
+	bool bProfileApplied = false;
+	TUniquePtr<FSettingsPersistence> Persistence;
+	void HandleProfileLoaded(TArray<uint8>&& Bytes);
+	void HandleLocalPlayerAdded(ULocalPlayer* LocalPlayer);
+	void ApplyProfile();
+	void SaveProfile();
+	FDelegateHandle LocalPlayerAddedHandle;
 };
@@ -0,0 +1,53 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Performance/QualityGovernor.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "QualityGovernorSubsystem.generated.h"
+
+class USettingsSaveGame;
+struct FUserSettingsData;
+
+/**
+ * Optional runtime scalability governor (ssp.Governor.Enable).
+ * Steps individual scalability groups to hold ssp.Governor.TargetFPS, never above the
+ * quality the player applied through USettingsSubsystem. Nothing it changes is saved.
+ */
+UCLASS()
+class SSPCORE_API UQualityGovernorSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	/** True while the governor owns the scalability levels */
+	UFUNCTION(BlueprintPure, Category="Yenum|Settings|Governor")
+	bool IsGoverning() const { return bGoverning; }
+
+	const FQualityGovernor& GetGovernor() const { return Governor; }
+
+private:
+	UFUNCTION()
+	void HandleSettingsApplied(USettingsSaveGame* AppliedSettings);
+
+	void StartGoverning();
+	void StopGoverning();
+	/** Ceiling from the player's per-group levels; engine levels if there are none yet */
+	static FQualityGovernor::FLevels GetUserLevels(const FUserSettingsData* UserSettings);
+	const FUserSettingsData* GetUserSettings() const;
+	void PushLevels(const FQualityGovernor::FLevels& Levels) const;
+
+	FQualityGovernor Governor;
+	bool bGoverning = false;
+};
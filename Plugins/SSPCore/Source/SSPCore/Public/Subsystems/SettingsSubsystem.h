@@ -3,10 +3,24 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "CVars/SettingsCVars.h"
+#include "Containers/Ticker.h"
 #include "Data/SettingsSaveGame.h"
+#include "Data/SettingsSchema.h"
+#include "Display/DisplayModeCache.h"
+#include "Performance/HardwareTier.h"
+#include "Performance/MemoryBudget.h"
+#include "Persistence/SettingsPersistence.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "SettingsSubsystem.generated.h"
 
+class USaveGame;
+class USettingsPreset;
+class USoundClass;
+class USoundMix;
+struct FDisplayMetrics;
+
 
 UENUM(BlueprintType)
 enum class EVolumeType : uint8
@@ -18,22 +32,44 @@ enum class EVolumeType : uint8
 	EVT_MAX UMETA(DisplayName = "DefaultMax"),
 };
 
+/** One row of the audio channel table, configured in DefaultGame.ini */
+USTRUCT(BlueprintType)
+struct FSettingsAudioChannel
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	FName Channel;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	TSoftObjectPtr<USoundClass> SoundClass;
+
+	// Used until the player sets this channel
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float DefaultVolume = 1.0f;
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnSettingsQueued);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSettingsInitialized, FPendingSettings, InitSettings);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSettingsApplied, USettingsSaveGame*, AppliedSettings);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSoundSettingsApplied, EVolumeType, SoundType);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSettingsReverted, FPendingSettings, RevertSettings);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSettingsResetToDefaults, FPendingSettings, DefaultSettings);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnSettingsReady);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSettingsPresetChanged, USettingsPreset*, ActivePreset);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMemoryPressureChanged, FSettingsMemoryPressure, Pressure);
 
 /**
  * 
  */
-UCLASS()
+UCLASS(Config=Game)
 class SSPCORE_API USettingsSubsystem : public UGameInstanceSubsystem
 {
 	GENERATED_BODY()
 public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
 	// EVENTS
 	/** Fired when any setting is queued but not yet applied */
 	UPROPERTY(BlueprintAssignable, Category="Settings|Events")
@@ -58,22 +94,88 @@ public:
 	/** Fired when settings are reset to default values */
 	UPROPERTY(BlueprintAssignable, Category="Settings|Events")
 	FOnSettingsResetToDefaults OnSettingsResetToDefaults;
+
+	/** Fired once, after the saved settings have been loaded off-thread and applied */
+	UPROPERTY(BlueprintAssignable, Category="Settings|Events")
+	FOnSettingsReady OnSettingsReady;
+
+	/** Fired when the detected preset changes; null when current values match no preset */
+	UPROPERTY(BlueprintAssignable, Category="Settings|Events")
+	FOnSettingsPresetChanged OnSettingsPresetChanged;
+
+	/** Fired when the texture streaming pool goes over or back under budget, or the recommendation moves */
+	UPROPERTY(BlueprintAssignable, Category="Settings|Events")
+	FOnMemoryPressureChanged OnMemoryPressureChanged;
+
+	/** True once the saved settings are loaded and applied. Queries before that return defaults. */
+	UFUNCTION(BlueprintPure, Category="Settings")
+	bool IsSettingsReady() const { return bSettingsReady; }
+
+	/** C++ counterpart of OnSettingsReady; already set if settings are ready */
+	TSharedFuture<void> GetSettingsReadyFuture() const { return SettingsReadyFuture; }
 	
 	// Will be used by UI but not saved until apply
 	// Graphics
 	void QueueGraphicsQuality(int32 Level);
+	// Overrides one group on top of the overall level; the overall level reads Custom (-1) once groups differ
+	void QueueScalabilityGroup(EScalabilityGroup Group, int32 Level);
 	void QueueResolution(int32 Index);
 	void QueueWindowMode(int32 Index);
 	//Volume - Master, SFX & Dialogue
 	void QueueVolume(float Value, EVolumeType VolumeType);
+	// Volume of any channel in the audio channel table
+	void QueueChannelVolume(FName Channel, float Value);
+	// Queues the volume and updates the mix live, at most once per ssp.Audio.PreviewInterval. Nothing is saved.
+	void PreviewChannelVolume(FName Channel, float Value);
 	// Brightness
 	void QueueBrightness(float Value);
+	// Performance - applied without a restart
+	void QueueFrameRateLimit(float FramesPerSecond);
+	void QueueVSync(bool bEnabled);
+	void QueueScreenPercentage(float Percentage);
+	void QueueDynamicResolution(bool bEnabled);
+	void QueueDynamicResolutionBudget(float MinScreenPercentage, float MaxScreenPercentage, float FrameTimeBudgetMs);
+	void QueueLatencyMode(ELatencyMode Mode);
+	// Memory budgets in MB, 0 = engine default
+	void QueueTexturePoolSize(int32 MegaBytes);
+	void QueueMeshPoolSize(int32 MegaBytes);
+	/** Last streaming pool sample, every ssp.Memory.PollInterval seconds */
+	const FSettingsMemoryPressure& GetMemoryPressure() const { return MemoryPressure; }
+	/** Largest texture pool recommended for this machine's RAM and VRAM */
+	int32 GetTexturePoolLimitMB() const { return TexturePoolLimitMB; }
+	/** Tier this machine was classified as on first run; Unknown until settings are ready */
+	EHardwareTier GetHardwareTier() const;
+	/** HardwareTiers from config, or the built-in table when the project sets none */
+	const TArray<FHardwareTierProfile>& GetHardwareTierProfiles() const;
+	// Any setting in FSettingsSchema by key; clamped to the schema range
+	void QueueSetting(FName Key, float Value);
+	/** Value of a schema setting including anything queued, or 0 for an unknown key */
+	float GetSettingValue(FName Key) const;
 
 	// Apply pending changes
 	UFUNCTION()
 	void ApplySettings();
+	// Registers SoundClass for SoundType's channel and commits every queued volume
 	UFUNCTION()
-	void ApplySoundSettings(USoundMix* SoundMix, USoundClass* SoundClass, EVolumeType SoundType) const;
+	void ApplySoundSettings(USoundMix* SoundMix, USoundClass* SoundClass, EVolumeType SoundType);
+
+	// Audio channel table
+	/** Mix the channel overrides live on; pushed once, then updated in place */
+	void SetVolumeSoundMix(USoundMix* SoundMix);
+	void RegisterAudioChannel(FName Channel, USoundClass* SoundClass);
+	TArray<FName> GetAudioChannels() const;
+	/** Volume of Channel including anything queued */
+	float GetChannelVolume(FName Channel) const;
+	static FName GetVolumeChannelName(EVolumeType VolumeType);
+
+	// Presets. Every performance field of the preset is queued and applied in one ApplySettings pass.
+	void ApplyPreset(const USettingsPreset* Preset);
+	const TArray<TObjectPtr<USettingsPreset>>& GetPresets() const { return Presets; }
+	/** Preset whose performance fields match the applied settings, or null */
+	USettingsPreset* GetActivePreset() const { return ActivePreset; }
+
+	// Shows queued brightness / dynamic resolution budget live without saving; Revert undoes it
+	void PreviewPendingSettings();
 
 	// Cancel pending changes (restore current applied settings)
 	UFUNCTION()
@@ -83,18 +185,28 @@ public:
 
 	
 	// For UI initial values
-	UFUNCTION()
-	static TArray<FString> GetAvailableResolutions();
+	// Served from memory; the resolution cache is rebuilt only when display metrics change
+	const TArray<FString>& GetAvailableResolutions() const;
 	UFUNCTION()
 	TArray<FString> GetWindowModes() const;
 	UFUNCTION()
 	int32 GetCurrentResolutionIndex() const;
+	// Display modes with refresh rates and the monitors that can show them
+	const FDisplayModeCache& GetDisplayModes() const { return DisplayModes; }
+	/** Monitor holding the game window, else the primary monitor */
+	int32 GetCurrentMonitorIndex() const;
+	// Queues the size and refresh rate of Mode. The RHI leaves the swapchain rate to the driver,
+	// so in exclusive fullscreen a rate is held with the frame rate limiter.
+	void QueueDisplayMode(const FSettingsDisplayMode& Mode);
+	// -1 when the scalability groups are a Custom mix
 	UFUNCTION()
 	static int32 GetCurrentGraphics();
 	UFUNCTION()
 	static int32 GetCurrentWindowMode();
-	UFUNCTION()
-	FPendingSettings GetCurrentSettingsData() const;
+	// Saved values with anything queued layered on top. Cached until the next queue, apply or revert;
+	// single settings are cheaper through GetSettingValue, GetChannelVolume and GetScalabilityGroupLevel.
+	const FPendingSettings& GetCurrentSettingsData() const;
+	int32 GetScalabilityGroupLevel(EScalabilityGroup Group) const;
 
 	
 	UFUNCTION()
@@ -103,13 +215,134 @@ public:
 	FORCEINLINE FPendingSettings GetPendingSettings() const { return PendingSettings; };
 	UFUNCTION()
 	FORCEINLINE USettingsSaveGame* GetSaveGame() const { return SaveGame; };
+
+	// Fields the last ApplySettings call actually pushed to the engine
+	ESettingsField GetLastAppliedFields() const { return LastAppliedFields; }
+
+	// Memory accounting for ssp.MemReport
+	SIZE_T GetAllocatedBytes() const;
+	int32 GetNumEventBindings() const;
+
+	// Startup cost for ssp.Bench: time spent inside Initialize, and from Initialize until ready
+	double GetInitializeMs() const { return InitializeMs; }
+	double GetTimeToReadyMs() const { return TimeToReadyMs; }
+	FSettingsPersistence* GetPersistence() const { return Persistence.Get(); }
+	// ssp.Bench and the automation tests point writes at scratch stores; each returns the store it replaced
+	TUniquePtr<FSettingsPersistence> ReplacePersistence(TUniquePtr<FSettingsPersistence> Store);
+	TUniquePtr<FSettingsPersistence> ReplaceStartupDisplayStore(TUniquePtr<FSettingsPersistence> Store);
+	bool HasPendingChanges() const { return bHasPendingChanges; }
 private:
 
 	UPROPERTY(VisibleAnywhere)
 	bool bHasPendingChanges = false;
-	// Save Settings to Data Store
-	const FUserSettingsData DefaultSettings;
+	// Save Settings to Data Store. Performance fields come from this machine's hardware tier.
+	FUserSettingsData DefaultSettings;
 	FPendingSettings PendingSettings;
+	// GetCurrentSettingsData's merge of SaveGame->Data and PendingSettings
+	mutable FPendingSettings CurrentSettingsCache;
+	mutable bool bCurrentSettingsCached = false;
+	void InvalidateCurrentSettings() { bCurrentSettingsCached = false; }
+
+	// What the engine is currently running with. ApplySettings diffs against this so unchanged
+	// fields never touch the engine and a no-op apply never touches the disk.
+	FUserSettingsData AppliedSettings;
+	ESettingsField LastAppliedFields = ESettingsField::None;
+	// CVar values shown by PreviewPendingSettings, rolled back on revert
+	FSettingsCVarTransaction PreviewTransaction;
+	void CaptureAppliedSettingsFromEngine();
+
+	// Settings registered with FSettingsSchema at runtime. Holds queued values too; the dirty
+	// bits are what ApplySettings still has to hand to the appliers.
+	FSettingsValues CustomSettings;
+	// Writes a built-in setting into PendingSettings or a registered one into CustomSettings
+	bool StageSetting(FName Key, float Value);
+	void ApplyCustomSettings(bool bAll);
+
+	// Initialization runs once: the slot loads on a background thread and is applied
+	// from its game-thread completion. Applies requested before then are deferred.
+	bool bInitializeStarted = false;
+	bool bSettingsReady = false;
+	bool bApplyWhenReady = false;
+	TPromise<void> SettingsReadyPromise;
+	TSharedFuture<void> SettingsReadyFuture;
+	double InitializeStartSeconds = 0.0;
+	double InitializeMs = 0.0;
+	double TimeToReadyMs = 0.0;
+	void HandleSaveGameLoaded(const FString& SlotName, const int32 UserIndex, USaveGame* Loaded);
+
+	// The snapshot is the only store written on apply. GameUserSettings.ini is written once,
+	// on shutdown; the snapshot re-applies anything it missed after a crash.
+	TUniquePtr<FSettingsPersistence> Persistence;
+	bool bGameUserSettingsDirty = false;
+	void HandleSnapshotLoaded(TArray<uint8>&& Payload);
+	void PersistSaveGame();
+	// Resolution and window mode for SSPCoreStartup to seed before the next window is created
+	TUniquePtr<FSettingsPersistence> StartupDisplayStore;
+	// What that file holds: what SSPCoreStartup read, then what was last written. Writes that
+	// would not change it are skipped.
+	TArray<uint8> StartupDisplayBytes;
+	void PersistStartupDisplay();
+	// Classifies the machine if the save has no tier yet and folds the tier's profile and a
+	// texture pool sized for the machine into DefaultSettings. Returns those fields, which are
+	// also what a machine with no saved settings starts with; bOutClassified is set when a new
+	// tier was stored in the save, which needs a real RHI.
+	FPendingSettings ResolveHardwareTier(bool& bOutClassified);
+
+	// Tier table, in any order:
+	// [/Script/SSPCore.SettingsSubsystem]
+	// +HardwareTiers=(Tier=High,MinCores=6,MinMemoryGB=16,MinVideoMemoryGB=6,bAllowIntegratedGPU=False,Preset="/Game/Settings/DA_High.DA_High")
+	UPROPERTY(Config)
+	TArray<FHardwareTierProfile> HardwareTiers;
+
+	FSettingsMemoryPressure MemoryPressure;
+	int32 TexturePoolLimitMB = 0;
+	FTSTicker::FDelegateHandle MemoryPressureTicker;
+	// Seconds since the last sample, checked against ssp.Memory.PollInterval every tick
+	float MemoryPollElapsed = 0.0f;
+	bool TickMemoryPressure(float DeltaTime);
+
+	// Display mode cache. Labels and reverse maps are built alongside the lists so UI
+	// queries are lookups, never formatting or string compares.
+	FDisplayModeCache DisplayModes;
+	int32 CurrentResolutionIndex = INDEX_NONE;
+	void RebuildResolutionCache(const FDisplayMetrics& Metrics);
+	void RefreshCurrentResolutionIndex();
+	// Points Data.ResolutionIndex at Data.Resolution in the current list, else at the window's size
+	void ResolveResolutionIndex(FUserSettingsData& Data) const;
+	void HandleDisplayMetricsChanged(const FDisplayMetrics& Metrics);
+	FDelegateHandle DisplayMetricsChangedHandle;
+
+	// Presets listed in DefaultGame.ini under [/Script/SSPCore.SettingsSubsystem],
+	// e.g. +PresetAssets=/Game/Settings/Presets/DA_BatterySaver.DA_BatterySaver
+	UPROPERTY(Config)
+	TArray<TSoftObjectPtr<USettingsPreset>> PresetAssets;
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<USettingsPreset>> Presets;
+	UPROPERTY(Transient)
+	TObjectPtr<USettingsPreset> ActivePreset;
+	void HandlePresetsLoaded();
+	void RefreshActivePreset();
+
+	// Audio channel table. Channels come from config and from RegisterAudioChannel.
+	// [/Script/SSPCore.SettingsSubsystem]
+	// +AudioChannels=(Channel="Music",SoundClass="/Game/Audio/SC_Music.SC_Music",DefaultVolume=0.8)
+	UPROPERTY(Config)
+	TArray<FSettingsAudioChannel> AudioChannels;
+	UPROPERTY(Config)
+	TSoftObjectPtr<USoundMix> VolumeSoundMixAsset;
+	UPROPERTY(Transient)
+	TObjectPtr<USoundMix> VolumeSoundMix;
+	UPROPERTY(Transient)
+	TMap<FName, TObjectPtr<USoundClass>> ChannelSoundClasses;
+	// What the mix currently holds per channel, so unchanged channels are skipped
+	TMap<FName, float> AppliedChannelVolumes;
+	bool bVolumeMixPushed = false;
+	FTSTicker::FDelegateHandle VolumePreviewTicker;
+	void HandleAudioAssetsLoaded();
+	void ApplyChannelVolumes(const FUserSettingsData& Target);
+	void CommitVolumes();
+	bool FlushVolumePreview(float DeltaTime);
+	float GetChannelDefaultVolume(FName Channel) const;
 
 	UPROPERTY(VisibleAnywhere)
 	USettingsSaveGame* SaveGame;
@@ -26,6 +26,8 @@ public class SSPCore : ModuleRules
 			new string[]
 			{
 				"Core",
+				"EnhancedInput",
+				"SSPCoreStartup",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -39,8 +41,11 @@ public class SSPCore : ModuleRules
 				"Slate",
 				"SlateCore",
 				"InputCore",
+				"ApplicationCore",
 				"RHI",
-				"RenderCore"
+				"RenderCore",
+				"GameplayTags",
+				"Json"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
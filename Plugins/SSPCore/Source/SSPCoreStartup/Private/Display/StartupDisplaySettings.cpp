@@ -0,0 +1,72 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Display/StartupDisplaySettings.h"
+
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/Paths.h"
+#include "Persistence/SettingsPersistence.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+static constexpr uint32 StartupDisplayVersion = 1;
+static TOptional<FStartupDisplaySettings> LoadedStartupDisplay;
+
+void FStartupDisplaySettings::Serialize(TArray<uint8>& OutBytes) const
+{
+	FMemoryWriter Writer(OutBytes);
+	uint32 Version = StartupDisplayVersion;
+	FIntPoint Size = Resolution;
+	int32 Mode = FullscreenMode;
+	Writer << Version << Size << Mode;
+}
+
+bool FStartupDisplaySettings::Deserialize(const TArray<uint8>& Bytes)
+{
+	FMemoryReader Reader(Bytes);
+	uint32 Version = 0;
+	Reader << Version << Resolution << FullscreenMode;
+	// Fullscreen, WindowedFullscreen, Windowed
+	return !Reader.IsError() && Version <= StartupDisplayVersion
+		&& Resolution.X > 0 && Resolution.Y > 0 && FullscreenMode >= 0 && FullscreenMode <= 2;
+}
+
+bool FStartupDisplaySettings::Load()
+{
+	TArray<uint8> Payload;
+	if (!FSettingsPersistence::LoadNow(GetPath(), Payload) || !Deserialize(Payload))
+	{
+		return false;
+	}
+	LoadedStartupDisplay = *this;
+	return true;
+}
+
+const TOptional<FStartupDisplaySettings>& FStartupDisplaySettings::GetLoaded()
+{
+	return LoadedStartupDisplay;
+}
+
+void FStartupDisplaySettings::SeedGameUserSettings() const
+{
+	if (!GConfig)
+	{
+		return;
+	}
+	// Projects can swap in their own settings class, which reads its own section
+	FString Section = TEXT("/Script/Engine.GameUserSettings");
+	GConfig->GetString(TEXT("/Script/Engine.Engine"), TEXT("GameUserSettingsClassName"), Section, GEngineIni);
+
+	GConfig->SetInt(*Section, TEXT("ResolutionSizeX"), Resolution.X, GGameUserSettingsIni);
+	GConfig->SetInt(*Section, TEXT("ResolutionSizeY"), Resolution.Y, GGameUserSettingsIni);
+	GConfig->SetInt(*Section, TEXT("LastUserConfirmedResolutionSizeX"), Resolution.X, GGameUserSettingsIni);
+	GConfig->SetInt(*Section, TEXT("LastUserConfirmedResolutionSizeY"), Resolution.Y, GGameUserSettingsIni);
+	GConfig->SetInt(*Section, TEXT("FullscreenMode"), FullscreenMode, GGameUserSettingsIni);
+	GConfig->SetInt(*Section, TEXT("LastConfirmedFullscreenMode"), FullscreenMode, GGameUserSettingsIni);
+	GConfig->SetInt(*Section, TEXT("PreferredFullscreenMode"), FullscreenMode, GGameUserSettingsIni);
+}
+
+FString FStartupDisplaySettings::GetPath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("SaveGames") / TEXT("YenumDisplay.settings");
+}
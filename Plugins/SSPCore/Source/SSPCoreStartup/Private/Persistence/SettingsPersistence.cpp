@@ -0,0 +1,156 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Persistence/SettingsPersistence.h"
+
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+	constexpr uint32 SnapshotMagic = 0x54455359; // "YSET"
+	constexpr int32 SnapshotHeaderSize = 4 * sizeof(uint32);
+}
+
+FSettingsPersistence::FSettingsPersistence(const FString& InPath)
+	: Path(InPath)
+	, TempPath(InPath + TEXT(".tmp"))
+	, BackupPath(InPath + TEXT(".bak"))
+{
+}
+
+FSettingsPersistence::~FSettingsPersistence()
+{
+	Flush();
+}
+
+void FSettingsPersistence::Write(TArray<uint8>&& Payload)
+{
+	FScopeLock Lock(&QueueLock);
+	Queued = MoveTemp(Payload);
+	if (!bWriting)
+	{
+		bWriting = true;
+		WriteTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this] { WriteQueued(); },
+			LowLevelTasks::ETaskPriority::BackgroundNormal);
+	}
+}
+
+void FSettingsPersistence::Flush()
+{
+	if (WriteTask.IsValid())
+	{
+		WriteTask.Wait();
+	}
+}
+
+void FSettingsPersistence::WriteQueued()
+{
+	for (;;)
+	{
+		TArray<uint8> Payload;
+		{
+			FScopeLock Lock(&QueueLock);
+			if (!Queued.IsSet())
+			{
+				bWriting = false;
+				return;
+			}
+			Payload = MoveTemp(Queued.GetValue());
+			Queued.Reset();
+		}
+		if (WriteSnapshot(Payload))
+		{
+			NumWrites.fetch_add(1, std::memory_order_relaxed);
+			NumBytesWritten.fetch_add(SnapshotHeaderSize + Payload.Num(), std::memory_order_relaxed);
+		}
+	}
+}
+
+bool FSettingsPersistence::WriteSnapshot(const TArray<uint8>& Payload) const
+{
+	TArray<uint8> Bytes;
+	Bytes.Reserve(SnapshotHeaderSize + Payload.Num());
+	FMemoryWriter Writer(Bytes);
+	uint32 Magic = SnapshotMagic;
+	uint32 SnapshotVersion = Version;
+	uint32 Size = Payload.Num();
+	uint32 Crc = FCrc::MemCrc32(Payload.GetData(), Payload.Num());
+	Writer << Magic << SnapshotVersion << Size << Crc;
+	Bytes.Append(Payload);
+
+	if (!FFileHelper::SaveArrayToFile(Bytes, *TempPath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SettingsPersistence: could not write %s"), *TempPath);
+		return false;
+	}
+
+	// A crash from here on leaves at least one intact copy: the temp file, the backup or the new file
+	IFileManager& FileManager = IFileManager::Get();
+	if (FileManager.FileExists(*Path))
+	{
+		FileManager.Move(*BackupPath, *Path, true, true);
+	}
+	if (!FileManager.Move(*Path, *TempPath, true, true))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SettingsPersistence: could not move %s into place"), *TempPath);
+		return false;
+	}
+	return true;
+}
+
+bool FSettingsPersistence::ReadSnapshot(const FString& File, TArray<uint8>& OutPayload)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *File, FILEREAD_Silent))
+	{
+		return false;
+	}
+	if (Bytes.Num() < SnapshotHeaderSize)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SettingsPersistence: %s is truncated"), *File);
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	uint32 Magic = 0, SnapshotVersion = 0, Size = 0, Crc = 0;
+	Reader << Magic << SnapshotVersion << Size << Crc;
+	if (Magic != SnapshotMagic || SnapshotVersion > Version || Size != static_cast<uint32>(Bytes.Num() - SnapshotHeaderSize))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SettingsPersistence: %s has a bad header"), *File);
+		return false;
+	}
+	const uint8* Data = Bytes.GetData() + SnapshotHeaderSize;
+	if (FCrc::MemCrc32(Data, Size) != Crc)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SettingsPersistence: %s failed its checksum"), *File);
+		return false;
+	}
+	OutPayload = TArray<uint8>(Data, Size);
+	return true;
+}
+
+bool FSettingsPersistence::LoadNow(const FString& InPath, TArray<uint8>& OutPayload)
+{
+	// A leftover temp file is newer than the main file: it only survives when the rename failed
+	return ReadSnapshot(InPath + TEXT(".tmp"), OutPayload)
+		|| ReadSnapshot(InPath, OutPayload)
+		|| ReadSnapshot(InPath + TEXT(".bak"), OutPayload);
+}
+
+void FSettingsPersistence::LoadAsync(TUniqueFunction<void(TArray<uint8>&&)> OnLoaded) const
+{
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [InPath = Path, OnLoaded = MoveTemp(OnLoaded)]() mutable
+	{
+		TArray<uint8> Payload;
+		LoadNow(InPath, Payload);
+		AsyncTask(ENamedThreads::GameThread, [OnLoaded = MoveTemp(OnLoaded), Payload = MoveTemp(Payload)]() mutable
+		{
+			OnLoaded(MoveTemp(Payload));
+		});
+	}, LowLevelTasks::ETaskPriority::BackgroundNormal);
+}
@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SSPCoreStartup.h"
+
+#include "Display/StartupDisplaySettings.h"
+#include "Misc/CoreMisc.h"
+
+#define LOCTEXT_NAMESPACE "FSSPCoreStartupModule"
+
+void FSSPCoreStartupModule::StartupModule()
+{
+	if (GIsEditor || IsRunningDedicatedServer() || IsRunningCommandlet())
+	{
+		return;
+	}
+	FStartupDisplaySettings Display;
+	if (Display.Load())
+	{
+		Display.SeedGameUserSettings();
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
+	
+IMPLEMENT_MODULE(FSSPCoreStartupModule, SSPCoreStartup)
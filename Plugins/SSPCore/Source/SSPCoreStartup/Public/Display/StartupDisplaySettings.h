@@ -0,0 +1,35 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * The part of the applied settings the game window is created with. USettingsSubsystem
+ * stores it next to the settings snapshot whenever the display mode is applied;
+ * SSPCoreStartup reads it back before the engine creates the window.
+ */
+struct SSPCORESTARTUP_API FStartupDisplaySettings
+{
+	FIntPoint Resolution = FIntPoint::ZeroValue;
+	// EWindowMode::Type value
+	int32 FullscreenMode = 1;
+
+	void Serialize(TArray<uint8>& OutBytes) const;
+	bool Deserialize(const TArray<uint8>& Bytes);
+
+	/** Reads the file at GetPath(). A valid copy is kept for GetLoaded. */
+	bool Load();
+	/** What Load read this run; unset when there was no valid file or nothing loaded it (editor, server) */
+	static const TOptional<FStartupDisplaySettings>& GetLoaded();
+
+	/**
+	 * Writes the resolution and window mode into the game user settings config, where
+	 * UGameUserSettings::LoadSettings picks them up. This dirties GameUserSettings.ini, so the
+	 * next flush writes them back; they are the mode that was applied last, which is what
+	 * that file holds after a clean exit anyway.
+	 */
+	void SeedGameUserSettings() const;
+
+	static FString GetPath();
+};
@@ -0,0 +1,60 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+
+/**
+ * Crash-safe file store for the settings snapshot.
+ *
+ * Writes run on a background task: the snapshot goes to a temp file, the current file
+ * becomes the backup, then the temp file is renamed into place. Every file carries a
+ * version and CRC, so a torn or corrupt file is skipped on load and the newest intact
+ * copy wins. Writes requested while one is in flight collapse into the newest payload.
+ */
+class SSPCORESTARTUP_API FSettingsPersistence
+{
+public:
+	explicit FSettingsPersistence(const FString& InPath);
+	~FSettingsPersistence();
+
+	FSettingsPersistence(const FSettingsPersistence&) = delete;
+	FSettingsPersistence& operator=(const FSettingsPersistence&) = delete;
+
+	/** Queues Payload and returns immediately */
+	void Write(TArray<uint8>&& Payload);
+	/** Blocks until every queued write is on disk */
+	void Flush();
+	/**
+	 * Reads and verifies the snapshot on a worker. OnLoaded runs on the game thread with
+	 * the payload, or an empty array when no intact copy exists.
+	 */
+	void LoadAsync(TUniqueFunction<void(TArray<uint8>&&)> OnLoaded) const;
+	/** Same as LoadAsync, on the calling thread. For startup code that runs before the game thread is up. */
+	static bool LoadNow(const FString& InPath, TArray<uint8>& OutPayload);
+
+	const FString& GetPath() const { return Path; }
+	/** Snapshots actually written; lower than requests when writes coalesced */
+	uint32 GetNumWrites() const { return NumWrites.load(std::memory_order_relaxed); }
+	/** Bytes of those snapshots, headers included */
+	uint64 GetNumBytesWritten() const { return NumBytesWritten.load(std::memory_order_relaxed); }
+
+	static constexpr uint32 Version = 1;
+
+private:
+	void WriteQueued();
+	bool WriteSnapshot(const TArray<uint8>& Payload) const;
+	static bool ReadSnapshot(const FString& File, TArray<uint8>& OutPayload);
+
+	FString Path;
+	FString TempPath;
+	FString BackupPath;
+
+	FCriticalSection QueueLock;
+	TOptional<TArray<uint8>> Queued;
+	bool bWriting = false;
+	UE::Tasks::FTask WriteTask;
+	std::atomic<uint32> NumWrites{ 0 };
+	std::atomic<uint64> NumBytesWritten{ 0 };
+};
@@ -0,0 +1,17 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Modules/ModuleManager.h"
+
+/**
+ * Loads right after the config system (PostConfigInit) and seeds the game user settings
+ * with the saved display mode, so the game window is created at its final size.
+ */
+class FSSPCoreStartupModule : public IModuleInterface
+{
+public:
+
+	/** IModuleInterface implementation */
+	virtual void StartupModule() override;
+};
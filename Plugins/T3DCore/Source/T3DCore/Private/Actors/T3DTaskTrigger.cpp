@@ -4,7 +4,7 @@
 #include "Actors/T3DTaskTrigger.h"
 
 #include "Components/BoxComponent.h"
-#include "Kismet/GameplayStatics.h"
+#include "GameFramework/Pawn.h"
 #include "Systems/T3DTaskSubsystem.h"
 
 
@@ -30,13 +30,23 @@ void AT3DTaskTrigger::BeginPlay()
 void AT3DTaskTrigger::OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
 	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
-	// simple player check
-	APawn* Pawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
-	if (OtherActor != Pawn) return;
+	UT3DTaskSubsystem* TS = GetGameInstance()->GetSubsystem<UT3DTaskSubsystem>();
+	if (!TS) return;
 
-	if (UT3DTaskSubsystem* TS = GetGameInstance()->GetSubsystem<UT3DTaskSubsystem>())
+	const APawn* Pawn = Cast<APawn>(OtherActor);
+	if (!Pawn || !Pawn->IsPlayerControlled()) return;
+	// A client also sees other players' pawns overlap; only its own counts there.
+	// On a server every connected player can walk in, credit whoever did.
+	if (!TS->IsServerEvaluating() && !Pawn->IsLocallyControlled()) return;
+
+	AController* Controller = Pawn->GetController();
+	if (bReachLocation)
+	{
+		TS->NotifyReachedLocationForPlayer(Controller);
+	}
+	else
 	{
-		TS->StartTask(TaskToStart);
+		TS->StartTaskForPlayer(Controller, TaskToStart);
 	}
 }
 
@@ -0,0 +1,11 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "HAL/LowLevelMemTracker.h"
+
+// LLM tags for T3DCore. Subsystem tags are children of T3DCore so "stat LLMFULL"
+// and memreport show both the plugin total and the per-subsystem split.
+LLM_DECLARE_TAG(T3DCore);
+LLM_DECLARE_TAG(T3DCore_TaskSubsystem);
+LLM_DECLARE_TAG(T3DCore_GameEvents);
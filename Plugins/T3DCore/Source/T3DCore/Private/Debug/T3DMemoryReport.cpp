@@ -0,0 +1,65 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Debug/T3DMemory.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Events/T3DGameEvents.h"
+#include "HAL/IConsoleManager.h"
+#include "Systems/T3DTaskSubsystem.h"
+#include "Systems/TaskSave.h"
+#include "UObject/UObjectIterator.h"
+
+LLM_DEFINE_TAG(T3DCore);
+LLM_DEFINE_TAG(T3DCore_TaskSubsystem, NAME_None, TEXT("T3DCore"));
+LLM_DEFINE_TAG(T3DCore_GameEvents, NAME_None, TEXT("T3DCore"));
+
+namespace T3DMemoryReport
+{
+	// One "key=value" line per section so CI can grep and diff the output
+	void Dump(UWorld* World, FOutputDevice& Ar)
+	{
+		// Lifetime average, not a recent rate
+		const double Minutes = FMath::Max((FPlatformTime::Seconds() - GStartTime) / 60.0, 1.0 / 60.0);
+
+		int32 NumTaskAssets = 0;
+		SIZE_T TaskAssetBytes = 0;
+		for (TObjectIterator<UT3DTaskData> It; It; ++It)
+		{
+			++NumTaskAssets;
+			TaskAssetBytes += It->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		}
+		Ar.Logf(TEXT("T3DMemReport TaskData count=%d bytes=%llu"), NumTaskAssets, static_cast<uint64>(TaskAssetBytes));
+
+		const uint32 SavesCreated = UTaskSave::GetNumCreated();
+		Ar.Logf(TEXT("T3DMemReport TaskSave created=%u per_minute_since_start=%.2f"), SavesCreated, SavesCreated / Minutes);
+
+		UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+		if (!GI)
+		{
+			Ar.Logf(TEXT("T3DMemReport no game instance, subsystem sections skipped"));
+			return;
+		}
+
+		if (const UT3DTaskSubsystem* TS = GI->GetSubsystem<UT3DTaskSubsystem>())
+		{
+			Ar.Logf(TEXT("T3DMemReport TaskSubsystem bytes=%llu"), static_cast<uint64>(TS->GetAllocatedBytes()));
+		}
+
+		if (const UT3DGameEvents* GE = GI->GetSubsystem<UT3DGameEvents>())
+		{
+			Ar.Logf(TEXT("T3DMemReport GameEvents bindings=%d bytes=%llu"),
+				GE->OnEnemyKilled.GetAllObjects().Num() + GE->OnItemCollected.GetAllObjects().Num(),
+				static_cast<uint64>(sizeof(UT3DGameEvents) + GE->OnEnemyKilled.GetAllocatedSize() + GE->OnItemCollected.GetAllocatedSize()));
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice T3DMemReportCommand(
+	TEXT("t3d.MemReport"),
+	TEXT("Dumps T3DCore memory use per subsystem, task asset footprint and UTaskSave creation rate."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		T3DMemoryReport::Dump(World, Ar);
+	}));
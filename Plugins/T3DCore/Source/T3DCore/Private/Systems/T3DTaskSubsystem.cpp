@@ -3,7 +3,10 @@
 
 #include "Systems/T3DTaskSubsystem.h"
 
+#include "Debug/T3DMemory.h"
 #include "Events/T3DGameEvents.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/GameModeBase.h"
 #include "Kismet/GameplayStatics.h"
 #include "Systems/TaskSave.h"
 
@@ -11,63 +14,111 @@
 void UT3DTaskSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
+	LLM_SCOPE_BYTAG(T3DCore_TaskSubsystem);
 
 	//Bind to Global Events
 	if (UT3DGameEvents* GE = GetGameInstance()->GetSubsystem<UT3DGameEvents>())
 	{
+		// Invocation lists live on the events subsystem, account them there
+		LLM_SCOPE_BYTAG(T3DCore_GameEvents);
 		GE->OnEnemyKilled.AddDynamic(this, &UT3DTaskSubsystem::NotifyEnemyKilled);
 		GE->OnItemCollected.AddDynamic(this, &UT3DTaskSubsystem::NotifyItemCollected);
+		GE->OnEnemyKilledByPlayer.AddDynamic(this, &UT3DTaskSubsystem::NotifyEnemyKilledByPlayer);
+		GE->OnItemCollectedByPlayer.AddDynamic(this, &UT3DTaskSubsystem::NotifyItemCollectedByPlayer);
+	}
+
+	LogoutHandle = FGameModeEvents::GameModeLogoutEvent.AddUObject(this, &UT3DTaskSubsystem::OnPlayerLogout);
+
+	// A dedicated server has no local player: no save slot to restore and nothing local to report
+	if (IsRunningDedicatedServer())
+	{
+		return;
+	}
+
+	if (FT3DTelemetrySink::IsEnabled())
+	{
+		Telemetry = MakeUnique<FT3DTelemetrySink>();
 	}
 
 	LoadTaskProgress();
+	ObjectiveStartSeconds = FPlatformTime::Seconds();
+	// Readers grabbing the buffer before the first tick should already see the restored task
+	PublishSnapshot();
+}
+
+void UT3DTaskSubsystem::Deinitialize()
+{
+	if (ActiveTask)
+	{
+		RecordTelemetry(ET3DTelemetryEvent::TaskAbandoned, CurrentObjectiveIndex, CurrentObjectiveCount);
+	}
+	// Joins the writer thread after it has drained the ring
+	Telemetry.Reset();
+
+	FGameModeEvents::GameModeLogoutEvent.Remove(LogoutHandle);
+	PlayerTasks.Empty();
+
+	Super::Deinitialize();
 }
 
 void UT3DTaskSubsystem::StartTask(UT3DTaskData* Task)
 {
 	if (!Task) return;
+	LLM_SCOPE_BYTAG(T3DCore_TaskSubsystem);
+	if (ActiveTask)
+	{
+		RecordTelemetry(ET3DTelemetryEvent::TaskAbandoned, CurrentObjectiveIndex, CurrentObjectiveCount);
+	}
 	ActiveTask = Task;
 	CurrentObjectiveIndex = 0;
 	CurrentObjectiveCount = 0;
+	ObjectiveStartSeconds = FPlatformTime::Seconds();
 	
 	UE_LOG(LogTemp, Log, TEXT("Task started: %s"), *Task->TaskID.ToString());
+	RecordTelemetry(ET3DTelemetryEvent::TaskStarted, 0, 0);
+	QueueProgressDelta(ET3DTaskChange::Started, Task->TaskID, 0, 0, GetCurrentObjectiveTargetCount());
 
 	SaveTaskProgress();
 }
 
 void UT3DTaskSubsystem::NotifyEnemyKilled(AActor* Enemy)
 {
-	if (!ActiveTask) return;
-
-	const FT3DTask& Obj = ActiveTask->Tasks[CurrentObjectiveIndex];
-	if (Obj.TaskType != ET3DTaskType::KillEnemy) return;
-
-	CurrentObjectiveCount++;
-	UE_LOG(LogTemp, Log, TEXT("Kill objective ++ (%d/%d)"), CurrentObjectiveCount, Obj.TargetCount);
-	AdvanceObjectiveIfComplete();
+	// Unattributed: every player on a matching objective, a listen server's host included
+	for (FT3DPlayerTaskState& State : PlayerTasks)
+	{
+		ProgressPlayerTask(State, ET3DTaskType::KillEnemy);
+	}
+	ProgressLocalTask(ET3DTaskType::KillEnemy);
 }
 
 void UT3DTaskSubsystem::NotifyItemCollected(FName ItemID)
 {
-	if (!ActiveTask) return;
-
-	const FT3DTask& Obj = ActiveTask->Tasks[CurrentObjectiveIndex];
-	if (Obj.TaskType != ET3DTaskType::CollectItem) return;
-
-	CurrentObjectiveCount++;
-	UE_LOG(LogTemp, Log, TEXT("Collect objective ++ (%d/%d)"), CurrentObjectiveCount, Obj.TargetCount);
-	AdvanceObjectiveIfComplete();
+	for (FT3DPlayerTaskState& State : PlayerTasks)
+	{
+		ProgressPlayerTask(State, ET3DTaskType::CollectItem);
+	}
+	ProgressLocalTask(ET3DTaskType::CollectItem);
 }
 
 void UT3DTaskSubsystem::NotifyReachedLocation()
 {
-	if (!ActiveTask) return;
+	// Reaching a place is always one player's doing; without a controller only the local player can be meant
+	UE_CLOG(IsRunningDedicatedServer(), LogTemp, Warning, TEXT("NotifyReachedLocation has no player on a dedicated server, use NotifyReachedLocationForPlayer"));
+	ProgressLocalTask(ET3DTaskType::ReachLocation);
+}
+
+void UT3DTaskSubsystem::ProgressLocalTask(ET3DTaskType Type)
+{
+	if (!ActiveTask || !ActiveTask->Tasks.IsValidIndex(CurrentObjectiveIndex)) return;
 
 	const FT3DTask& Obj = ActiveTask->Tasks[CurrentObjectiveIndex];
-	if (Obj.TaskType != ET3DTaskType::ReachLocation) return;
+	if (Obj.TaskType != Type) return;
 
 	// For reach-location objectives we assume trigger fires once
-	CurrentObjectiveCount = Obj.TargetCount;
-	UE_LOG(LogTemp, Log, TEXT("Reached location objective"));
+	CurrentObjectiveCount = Type == ET3DTaskType::ReachLocation ? Obj.TargetCount : CurrentObjectiveCount + 1;
+	UE_LOG(LogTemp, Log, TEXT("Objective progress (%d/%d)"), CurrentObjectiveCount, Obj.TargetCount);
+	RecordTelemetry(ET3DTelemetryEvent::ObjectiveProgress, CurrentObjectiveIndex, CurrentObjectiveCount);
+	QueueProgressDelta(ET3DTaskChange::Progress, ActiveTask->TaskID, CurrentObjectiveIndex, CurrentObjectiveCount, Obj.TargetCount);
 	AdvanceObjectiveIfComplete();
 }
 
@@ -76,8 +127,24 @@ FName UT3DTaskSubsystem::GetActiveTaskID() const
 	return  ActiveTask ? ActiveTask->TaskID : NAME_None;
 }
 
+SIZE_T UT3DTaskSubsystem::GetAllocatedBytes() const
+{
+	return sizeof(UT3DTaskSubsystem)
+		+ PendingDeltas.GetAllocatedSize()
+		+ SaveSlotName.GetAllocatedSize()
+		+ PlayerTasks.GetAllocatedSize()
+		+ (Telemetry ? Telemetry->GetAllocatedSize() : 0);
+}
+
+int32 UT3DTaskSubsystem::GetCurrentObjectiveTargetCount() const
+{
+	if (!ActiveTask || !ActiveTask->Tasks.IsValidIndex(CurrentObjectiveIndex)) return 0;
+	return ActiveTask->Tasks[CurrentObjectiveIndex].TargetCount;
+}
+
 void UT3DTaskSubsystem::SaveTaskProgress()
 {
+	LLM_SCOPE_BYTAG(T3DCore_TaskSubsystem);
 	UTaskSave* TSG = Cast<UTaskSave>(UGameplayStatics::CreateSaveGameObject(UTaskSave::StaticClass()));
 	if (!TSG) return;
 
@@ -91,6 +158,7 @@ void UT3DTaskSubsystem::SaveTaskProgress()
 
 void UT3DTaskSubsystem::LoadTaskProgress()
 {
+	LLM_SCOPE_BYTAG(T3DCore_TaskSubsystem);
 	if (!UGameplayStatics::DoesSaveGameExist(SaveSlotName, UserIndex)) return;
 
 	
@@ -127,6 +195,8 @@ void UT3DTaskSubsystem::AdvanceObjectiveIfComplete()
 	if (CurrentObjectiveCount >= Obj.TargetCount)
 	{
 		UE_LOG(LogTemp, Log, TEXT("Task complete: %s"), *Obj.TaskName.ToString());
+		RecordTelemetry(ET3DTelemetryEvent::ObjectiveCompleted, CurrentObjectiveIndex, CurrentObjectiveCount);
+		ObjectiveStartSeconds = FPlatformTime::Seconds();
 
 		// Move to next objective
 		CurrentObjectiveIndex++;
@@ -140,6 +210,7 @@ void UT3DTaskSubsystem::AdvanceObjectiveIfComplete()
 		{
 			// Next objective started
 			UE_LOG(LogTemp, Log, TEXT("Next objective index: %d"), CurrentObjectiveIndex);
+			QueueProgressDelta(ET3DTaskChange::Advanced, ActiveTask->TaskID, CurrentObjectiveIndex, 0, GetCurrentObjectiveTargetCount());
 		}
 
 		SaveTaskProgress();
@@ -149,6 +220,10 @@ void UT3DTaskSubsystem::AdvanceObjectiveIfComplete()
 void UT3DTaskSubsystem::CompleteTask()
 {
 	UE_LOG(LogTemp, Log, TEXT("Mission Complete: %s"), *ActiveTask->TaskID.ToString());
+	const int32 LastIndex = ActiveTask->Tasks.Num() - 1;
+	const int32 LastTarget = ActiveTask->Tasks.IsValidIndex(LastIndex) ? ActiveTask->Tasks[LastIndex].TargetCount : 0;
+	QueueProgressDelta(ET3DTaskChange::Completed, ActiveTask->TaskID, LastIndex, LastTarget, LastTarget);
+	RecordTelemetry(ET3DTelemetryEvent::TaskCompleted, LastIndex, LastTarget);
 	// handle reward, UI update, etc.
 	ActiveTask = nullptr;
 	CurrentObjectiveIndex = 0;
@@ -156,3 +231,191 @@ void UT3DTaskSubsystem::CompleteTask()
 
 	SaveTaskProgress();
 }
+
+void UT3DTaskSubsystem::QueueProgressDelta(ET3DTaskChange Change, FName TaskID, int32 ObjectiveIndex, int32 Count, int32 TargetCount)
+{
+	LLM_SCOPE_BYTAG(T3DCore_TaskSubsystem);
+	// Only a handful of objectives change per frame, a linear scan beats hashing here
+	FT3DTaskProgressDelta* Delta = PendingDeltas.FindByPredicate([&](const FT3DTaskProgressDelta& D)
+	{
+		return D.TaskID == TaskID && D.ObjectiveIndex == ObjectiveIndex;
+	});
+	if (!Delta)
+	{
+		Delta = &PendingDeltas.AddDefaulted_GetRef();
+		Delta->TaskID = TaskID;
+		Delta->ObjectiveIndex = ObjectiveIndex;
+	}
+
+	Delta->Changes |= static_cast<int32>(Change);
+	Delta->Count = Count;
+	Delta->TargetCount = TargetCount;
+	bSnapshotDirty = true;
+}
+
+void UT3DTaskSubsystem::FlushProgressDeltas()
+{
+	if (PendingDeltas.Num() == 0) return;
+
+	// Swap out first so listeners that start another task queue into a fresh frame
+	TArray<FT3DTaskProgressDelta> Deltas = MoveTemp(PendingDeltas);
+	PendingDeltas.Reset();
+
+	OnTaskProgressChangedNative.Broadcast(Deltas);
+	OnTaskProgressChanged.Broadcast(Deltas);
+}
+
+void UT3DTaskSubsystem::Tick(float DeltaTime)
+{
+	if (bSnapshotDirty)
+	{
+		PublishSnapshot();
+	}
+	FlushProgressDeltas();
+}
+
+void UT3DTaskSubsystem::PublishSnapshot()
+{
+	FT3DTaskSnapshot Snapshot;
+	Snapshot.TaskID = GetActiveTaskID();
+	Snapshot.ObjectiveIndex = CurrentObjectiveIndex;
+	Snapshot.ObjectiveCount = CurrentObjectiveCount;
+	Snapshot.ObjectiveTargetCount = GetCurrentObjectiveTargetCount();
+	Snapshot.NumObjectives = ActiveTask ? ActiveTask->Tasks.Num() : 0;
+	Snapshot.FrameNumber = GFrameCounter;
+
+	SnapshotBuffer->Publish(Snapshot);
+	bSnapshotDirty = false;
+}
+
+ETickableTickType UT3DTaskSubsystem::GetTickableTickType() const
+{
+	// The CDO never has anything to flush
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UT3DTaskSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UT3DTaskSubsystem, STATGROUP_Tickables);
+}
+
+void UT3DTaskSubsystem::RecordTelemetry(ET3DTelemetryEvent Event, int32 ObjectiveIndex, int32 Count) const
+{
+	if (!Telemetry || !ActiveTask) return;
+
+	const FT3DTask* Obj = ActiveTask->Tasks.IsValidIndex(ObjectiveIndex) ? &ActiveTask->Tasks[ObjectiveIndex] : nullptr;
+	Telemetry->Record(Event, ActiveTask->TaskID,
+		Obj ? Obj->TaskType : ET3DTaskType::ReachLocation,
+		ObjectiveIndex, Count,
+		Obj ? Obj->TargetCount : 0,
+		static_cast<float>(FPlatformTime::Seconds() - ObjectiveStartSeconds));
+}
+
+bool UT3DTaskSubsystem::IsServerEvaluating() const
+{
+	const UWorld* World = GetWorld();
+	return World && (World->GetNetMode() == NM_DedicatedServer || World->GetNetMode() == NM_ListenServer);
+}
+
+bool UT3DTaskSubsystem::IsLocalTaskOwner(const AController* Player) const
+{
+	// The host of a listen server keeps the local task, with its widgets, telemetry and save slot
+	return !IsServerEvaluating() || (Player && Player->IsLocalController());
+}
+
+void UT3DTaskSubsystem::ProgressTaskForPlayer(AController* Player, ET3DTaskType Type)
+{
+	if (IsLocalTaskOwner(Player))
+	{
+		ProgressLocalTask(Type);
+	}
+	else if (FT3DPlayerTaskState* State = FindPlayerTask(Player))
+	{
+		ProgressPlayerTask(*State, Type);
+	}
+}
+
+void UT3DTaskSubsystem::StartTaskForPlayer(AController* Player, UT3DTaskData* Task)
+{
+	if (!Player || !Task) return;
+	if (IsLocalTaskOwner(Player))
+	{
+		StartTask(Task);
+		return;
+	}
+	LLM_SCOPE_BYTAG(T3DCore_TaskSubsystem);
+
+	FT3DPlayerTaskState* State = FindPlayerTask(Player);
+	if (!State)
+	{
+		// Reuse a slot left by a player whose controller is gone before growing the array
+		State = PlayerTasks.FindByPredicate([](const FT3DPlayerTaskState& S) { return !S.Player.IsValid(); });
+		if (!State)
+		{
+			State = &PlayerTasks.AddDefaulted_GetRef();
+		}
+		State->Player = Player;
+	}
+
+	State->Task = Task;
+	State->ObjectiveIndex = 0;
+	State->ObjectiveCount = 0;
+	UE_LOG(LogTemp, Log, TEXT("Task started for %s: %s"), *Player->GetName(), *Task->TaskID.ToString());
+}
+
+void UT3DTaskSubsystem::NotifyEnemyKilledByPlayer(AActor* Enemy, AController* Killer)
+{
+	ProgressTaskForPlayer(Killer, ET3DTaskType::KillEnemy);
+}
+
+void UT3DTaskSubsystem::NotifyItemCollectedByPlayer(FName ItemID, AController* Collector)
+{
+	ProgressTaskForPlayer(Collector, ET3DTaskType::CollectItem);
+}
+
+void UT3DTaskSubsystem::NotifyReachedLocationForPlayer(AController* Player)
+{
+	ProgressTaskForPlayer(Player, ET3DTaskType::ReachLocation);
+}
+
+const FT3DPlayerTaskState* UT3DTaskSubsystem::FindPlayerTask(const AController* Player) const
+{
+	return const_cast<UT3DTaskSubsystem*>(this)->FindPlayerTask(Player);
+}
+
+FT3DPlayerTaskState* UT3DTaskSubsystem::FindPlayerTask(const AController* Player)
+{
+	if (!Player) return nullptr;
+	// Player counts are small, a scan over 24-byte entries is cheaper than a map
+	return PlayerTasks.FindByPredicate([Player](const FT3DPlayerTaskState& S) { return S.Player.Get() == Player; });
+}
+
+bool UT3DTaskSubsystem::ProgressPlayerTask(FT3DPlayerTaskState& State, ET3DTaskType Type)
+{
+	if (!State.Task || !State.Task->Tasks.IsValidIndex(State.ObjectiveIndex)) return false;
+
+	const FT3DTask& Obj = State.Task->Tasks[State.ObjectiveIndex];
+	if (Obj.TaskType != Type) return false;
+
+	// Reach-location objectives complete on the first trigger, same as the local path
+	State.ObjectiveCount = Type == ET3DTaskType::ReachLocation ? Obj.TargetCount : State.ObjectiveCount + 1;
+	if (State.ObjectiveCount < Obj.TargetCount) return true;
+
+	State.ObjectiveIndex++;
+	State.ObjectiveCount = 0;
+	if (State.ObjectiveIndex >= State.Task->Tasks.Num())
+	{
+		UE_LOG(LogTemp, Log, TEXT("Mission Complete for %s: %s"),
+			State.Player.IsValid() ? *State.Player->GetName() : TEXT("<gone>"), *State.Task->TaskID.ToString());
+		State.Task = nullptr;
+		State.ObjectiveIndex = 0;
+	}
+	return true;
+}
+
+void UT3DTaskSubsystem::OnPlayerLogout(AGameModeBase* GameMode, AController* Exiting)
+{
+	if (!GameMode || GameMode->GetGameInstance() != GetGameInstance()) return;
+
+	PlayerTasks.RemoveAllSwap([Exiting](const FT3DPlayerTaskState& S) { return !S.Player.IsValid() || S.Player.Get() == Exiting; });
+}
@@ -2,3 +2,18 @@
 
 
 #include "Systems/TaskSave.h"
+
+static std::atomic<uint32> GNumTaskSavesCreated{ 0 };
+
+UTaskSave::UTaskSave()
+{
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		GNumTaskSavesCreated.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+uint32 UTaskSave::GetNumCreated()
+{
+	return GNumTaskSavesCreated.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,222 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Telemetry/T3DTelemetrySink.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Paths.h"
+
+DECLARE_STATS_GROUP(TEXT("T3DCore"), STATGROUP_T3DCore, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Telemetry Record"), STAT_T3DTelemetryRecord, STATGROUP_T3DCore);
+
+static TAutoConsoleVariable<bool> CVarT3DTelemetryEnabled(
+	TEXT("t3d.Telemetry.Enabled"),
+	true,
+	TEXT("Write task progression telemetry to Saved/Telemetry/. Read when the task subsystem starts."));
+
+static TAutoConsoleVariable<int32> CVarT3DTelemetryMaxFileKB(
+	TEXT("t3d.Telemetry.MaxFileKB"),
+	1024,
+	TEXT("Size after which the telemetry CSV is rotated into a new part."));
+
+static TAutoConsoleVariable<int32> CVarT3DTelemetryMaxFiles(
+	TEXT("t3d.Telemetry.MaxFiles"),
+	10,
+	TEXT("Number of telemetry CSV files kept in Saved/Telemetry/. Oldest are deleted first."));
+
+namespace T3DTelemetry
+{
+	// Power of two keeps the ring index math cheap; ~150 KB of records
+	constexpr uint32 RingCapacity = 4096;
+	// Writer wakes at least this often even when the ring is quiet
+	constexpr uint32 FlushIntervalMs = 500;
+
+	const TCHAR* ToString(ET3DTelemetryEvent Event)
+	{
+		switch (Event)
+		{
+		case ET3DTelemetryEvent::TaskStarted:        return TEXT("task_started");
+		case ET3DTelemetryEvent::ObjectiveProgress:  return TEXT("objective_progress");
+		case ET3DTelemetryEvent::ObjectiveCompleted: return TEXT("objective_completed");
+		case ET3DTelemetryEvent::TaskCompleted:      return TEXT("task_completed");
+		case ET3DTelemetryEvent::TaskAbandoned:      return TEXT("task_abandoned");
+		default:                                     return TEXT("unknown");
+		}
+	}
+
+	const TCHAR* ToString(ET3DTaskType Type)
+	{
+		switch (Type)
+		{
+		case ET3DTaskType::ReachLocation: return TEXT("reach_location");
+		case ET3DTaskType::KillEnemy:     return TEXT("kill_enemy");
+		case ET3DTaskType::CollectItem:   return TEXT("collect_item");
+		default:                          return TEXT("unknown");
+		}
+	}
+
+	constexpr const TCHAR* Header = TEXT("session_seconds,event,task_id,objective_index,objective_type,count,target_count,objective_seconds\n");
+}
+
+FT3DTelemetrySink::FT3DTelemetrySink()
+	: Ring(T3DTelemetry::RingCapacity)
+{
+	SessionStartSeconds = FPlatformTime::Seconds();
+	Directory = FPaths::ProjectSavedDir() / TEXT("Telemetry");
+	SessionStamp = FDateTime::Now().ToString();
+	LineBuffer.Reserve(16 * 1024);
+	LineBufferBytes.store(LineBuffer.GetAllocatedSize(), std::memory_order_relaxed);
+
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("T3DTelemetryWriter"), 0, TPri_BelowNormal);
+}
+
+FT3DTelemetrySink::~FT3DTelemetrySink()
+{
+	if (Thread)
+	{
+		// Stop() wakes the writer, Run() drains what is left before returning
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+bool FT3DTelemetrySink::IsEnabled()
+{
+	return CVarT3DTelemetryEnabled.GetValueOnGameThread();
+}
+
+SIZE_T FT3DTelemetrySink::GetAllocatedSize() const
+{
+	// The ring is allocated once at full capacity; LineBuffer belongs to the writer thread,
+	// which publishes its size after every drain
+	return sizeof(FT3DTelemetrySink)
+		+ T3DTelemetry::RingCapacity * sizeof(FT3DTelemetryRecord)
+		+ LineBufferBytes.load(std::memory_order_relaxed)
+		+ Directory.GetAllocatedSize()
+		+ SessionStamp.GetAllocatedSize();
+}
+
+void FT3DTelemetrySink::Record(ET3DTelemetryEvent Event, FName TaskID, ET3DTaskType TaskType, int32 ObjectiveIndex, int32 Count, int32 TargetCount, float ObjectiveSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_T3DTelemetryRecord);
+
+	FT3DTelemetryRecord Record;
+	Record.SessionSeconds = GetSessionSeconds();
+	Record.TaskID = TaskID;
+	Record.ObjectiveIndex = ObjectiveIndex;
+	Record.Count = Count;
+	Record.TargetCount = TargetCount;
+	Record.ObjectiveSeconds = ObjectiveSeconds;
+	Record.Event = Event;
+	Record.TaskType = TaskType;
+
+	if (!Ring.Enqueue(Record))
+	{
+		DroppedCount.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+uint32 FT3DTelemetrySink::Run()
+{
+	while (!bStopping.load(std::memory_order_acquire))
+	{
+		WakeEvent->Wait(T3DTelemetry::FlushIntervalMs);
+		DrainRing();
+	}
+
+	// Pick up anything recorded between the last wait and Stop()
+	DrainRing();
+	Writer.Reset();
+	return 0;
+}
+
+void FT3DTelemetrySink::Stop()
+{
+	bStopping.store(true, std::memory_order_release);
+	WakeEvent->Trigger();
+}
+
+void FT3DTelemetrySink::DrainRing()
+{
+	if (Ring.IsEmpty()) return;
+
+	if (!Writer)
+	{
+		OpenNextFile();
+	}
+
+	FT3DTelemetryRecord Record;
+	if (!Writer)
+	{
+		// Keep the ring moving so the game thread never backs up on a bad disk
+		while (Ring.Dequeue(Record))
+		{
+			DroppedCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		return;
+	}
+
+	while (Ring.Dequeue(Record))
+	{
+		LineBuffer.Appendf(TEXT("%.3f,%s,%s,%d,%s,%d,%d,%.3f\n"),
+			Record.SessionSeconds,
+			T3DTelemetry::ToString(Record.Event),
+			*Record.TaskID.ToString(),
+			Record.ObjectiveIndex,
+			T3DTelemetry::ToString(Record.TaskType),
+			Record.Count,
+			Record.TargetCount,
+			Record.ObjectiveSeconds);
+	}
+
+	const FTCHARToUTF8 Utf8(*LineBuffer, LineBuffer.Len());
+	Writer->Serialize((void*)Utf8.Get(), Utf8.Length());
+	Writer->Flush();
+	LineBuffer.Reset();
+	LineBufferBytes.store(LineBuffer.GetAllocatedSize(), std::memory_order_relaxed);
+
+	if (Writer->Tell() >= static_cast<int64>(CVarT3DTelemetryMaxFileKB.GetValueOnAnyThread()) * 1024)
+	{
+		Writer.Reset();
+		++FilePart;
+	}
+}
+
+void FT3DTelemetrySink::OpenNextFile()
+{
+	const FString FilePath = Directory / FString::Printf(TEXT("T3DTelemetry-%s-%02d.csv"), *SessionStamp, FilePart);
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*FilePath, FILEWRITE_AllowRead));
+	if (!Writer)
+	{
+		UE_CLOG(!bReportedOpenFailure, LogTemp, Warning, TEXT("Telemetry: could not open %s, records will be dropped"), *FilePath);
+		bReportedOpenFailure = true;
+		return;
+	}
+
+	const FTCHARToUTF8 Utf8(T3DTelemetry::Header);
+	Writer->Serialize((void*)Utf8.Get(), Utf8.Length());
+	PruneOldFiles();
+}
+
+void FT3DTelemetrySink::PruneOldFiles() const
+{
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(Directory / TEXT("T3DTelemetry-*.csv")), true, false);
+
+	const int32 MaxFiles = FMath::Max(1, CVarT3DTelemetryMaxFiles.GetValueOnAnyThread());
+	if (Files.Num() <= MaxFiles) return;
+
+	// Session stamp and part are zero padded, so name order is creation order
+	Files.Sort();
+	for (int32 i = 0; i < Files.Num() - MaxFiles; ++i)
+	{
+		IFileManager::Get().Delete(*(Directory / Files[i]));
+	}
+}
@@ -19,6 +19,10 @@ public:
 	UPROPERTY(EditAnywhere)
 	UT3DTaskData* TaskToStart;
 
+	// Completes the overlapping player's reach-location objective instead of starting TaskToStart
+	UPROPERTY(EditAnywhere)
+	bool bReachLocation = false;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -6,8 +6,12 @@
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "T3DGameEvents.generated.h"
 
+class AController;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnEnemyKilled, AActor*, Enemy);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnItemCollected, FName, ItemID);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnEnemyKilledByPlayer, AActor*, Enemy, AController*, Killer);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnItemCollectedByPlayer, FName, ItemID, AController*, Collector);
 /**
  * 
  */
@@ -22,4 +26,12 @@ public:
 
 	UPROPERTY(BlueprintAssignable)
 	FOnItemCollected OnItemCollected;
+
+	// Attributed variants for multiplayer. On a server these credit only the given player,
+	// the unattributed events above credit every player on a matching objective.
+	UPROPERTY(BlueprintAssignable)
+	FOnEnemyKilledByPlayer OnEnemyKilledByPlayer;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnItemCollectedByPlayer OnItemCollectedByPlayer;
 };
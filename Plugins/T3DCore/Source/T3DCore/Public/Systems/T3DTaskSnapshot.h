@@ -0,0 +1,79 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+// Plain copy of the local task state. Trivially copyable so it can be read without the subsystem.
+struct FT3DTaskSnapshot
+{
+	// NAME_None when no task is active
+	FName TaskID;
+	int32 ObjectiveIndex = 0;
+	int32 ObjectiveCount = 0;
+	int32 ObjectiveTargetCount = 0;
+	int32 NumObjectives = 0;
+	// GFrameCounter at publish, lets readers tell whether anything moved since their last read
+	uint64 FrameNumber = 0;
+};
+
+/**
+ * Double-buffered snapshot of task state for readers off the game thread.
+ *
+ * The game thread fills the back slot and swaps it to the front with an atomic pointer store.
+ * Readers copy the front slot and check its version, retrying only in the rare case they
+ * were still on a slot the writer has since started refilling (two publishes later).
+ * Neither side takes a lock.
+ */
+class FT3DTaskSnapshotBuffer
+{
+public:
+	// Game thread only
+	void Publish(const FT3DTaskSnapshot& Snapshot)
+	{
+		FSlot* Back = Front.load(std::memory_order_relaxed) == &Slots[0] ? &Slots[1] : &Slots[0];
+
+		// Odd version marks the slot as being written
+		const uint32 Version = Back->Version.load(std::memory_order_relaxed);
+		Back->Version.store(Version + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		Back->Snapshot = Snapshot;
+
+		Back->Version.store(Version + 2, std::memory_order_release);
+		Front.store(Back, std::memory_order_release);
+	}
+
+	// Any thread
+	FT3DTaskSnapshot Read() const
+	{
+		for (;;)
+		{
+			const FSlot* Slot = Front.load(std::memory_order_acquire);
+			const uint32 Before = Slot->Version.load(std::memory_order_acquire);
+			if (Before & 1)
+			{
+				continue;
+			}
+
+			FT3DTaskSnapshot Copy = Slot->Snapshot;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (Slot->Version.load(std::memory_order_relaxed) == Before)
+			{
+				return Copy;
+			}
+		}
+	}
+
+private:
+	// Separate cache lines so readers of the front slot don't contend with writes to the back
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FSlot
+	{
+		std::atomic<uint32> Version{ 0 };
+		FT3DTaskSnapshot Snapshot;
+	};
+
+	FSlot Slots[2];
+	std::atomic<FSlot*> Front{ &Slots[0] };
+};
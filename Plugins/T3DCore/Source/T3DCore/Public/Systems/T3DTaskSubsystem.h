@@ -5,38 +5,149 @@
 #include "CoreMinimal.h"
 #include "Data/T3DTaskData.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "Systems/T3DTaskSnapshot.h"
+#include "Telemetry/T3DTelemetrySink.h"
+#include "Tickable.h"
 #include "T3DTaskSubsystem.generated.h"
 
+class AController;
+class AGameModeBase;
+
+// Kinds of change a progress delta can carry. Several can be set on one delta when
+// they happen to the same objective within a frame.
+UENUM(BlueprintType, meta=(Bitflags, UseEnumValuesAsMaskValuesInEditor="true"))
+enum class ET3DTaskChange : uint8
+{
+	None		= 0 UMETA(Hidden),
+	Started		= 1 << 0,
+	Progress	= 1 << 1,
+	Advanced	= 1 << 2,
+	Completed	= 1 << 3
+};
+ENUM_CLASS_FLAGS(ET3DTaskChange);
+
+USTRUCT(BlueprintType)
+struct FT3DTaskProgressDelta
+{
+	GENERATED_BODY()
+
+	// ET3DTaskChange flags accumulated for this objective during the frame
+	UPROPERTY(BlueprintReadOnly, meta=(Bitmask, BitmaskEnum="/Script/T3DCore.ET3DTaskChange"))
+	int32 Changes = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	FName TaskID;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 ObjectiveIndex = 0;
+
+	// Latest count for the objective once every change of the frame is folded in
+	UPROPERTY(BlueprintReadOnly)
+	int32 Count = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 TargetCount = 0;
+
+	bool HasChange(ET3DTaskChange Change) const { return (Changes & static_cast<int32>(Change)) != 0; }
+};
+
+// Server-side progress for one connected player. Kept to a weak key, the task asset and
+// two counters so a full server stays within a few bytes per player.
+USTRUCT()
+struct FT3DPlayerTaskState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TWeakObjectPtr<AController> Player;
+
+	UPROPERTY()
+	TObjectPtr<UT3DTaskData> Task = nullptr;
+
+	int32 ObjectiveIndex = 0;
+	int32 ObjectiveCount = 0;
+};
+
+// Fired at most once per frame with every objective that changed since the last flush
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTaskProgressChangedNative, TConstArrayView<FT3DTaskProgressDelta>);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTaskProgressChanged, const TArray<FT3DTaskProgressDelta>&, Deltas);
+
 /**
  * 
  */
 UCLASS()
-class T3DCORE_API UT3DTaskSubsystem : public UGameInstanceSubsystem
+class T3DCORE_API UT3DTaskSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
 {
 	GENERATED_BODY()
 
 	
 public:
+	// Progress stream for UI. Changes are coalesced per objective and flushed once per frame,
+	// so widgets can bind here instead of polling every tick.
+	FOnTaskProgressChangedNative OnTaskProgressChangedNative;
+
+	UPROPERTY(BlueprintAssignable, Category="T3D|Task")
+	FOnTaskProgressChanged OnTaskProgressChanged;
+
 	// Start a mission (by data asset)
 	void StartTask(UT3DTaskData* Task);
 
+	// Attributed events. On a server each remote player has its own state; the local player
+	// (standalone, client or listen server host) goes through the local, saved task.
+	void StartTaskForPlayer(AController* Player, UT3DTaskData* Task);
+	UFUNCTION()
+	void NotifyEnemyKilledByPlayer(AActor* Enemy, AController* Killer);
+	UFUNCTION()
+	void NotifyItemCollectedByPlayer(FName ItemID, AController* Collector);
+	UFUNCTION(BlueprintCallable, Category="T3D|Task")
+	void NotifyReachedLocationForPlayer(AController* Player);
+	const FT3DPlayerTaskState* FindPlayerTask(const AController* Player) const;
+
+	// True when task state is tracked per player instead of through the local task
+	bool IsServerEvaluating() const;
+
 	// Called when an event happens (kill/collect/location)
 	UFUNCTION()
 	void NotifyEnemyKilled(AActor* Enemy);
 	UFUNCTION()
 	void NotifyItemCollected(FName ItemID);
+	// Unattributed, so only the local player is credited. Location triggers pass the
+	// overlapping controller to NotifyReachedLocationForPlayer instead.
 	UFUNCTION()
-	void NotifyReachedLocation(); // location trigger simply calls this
+	void NotifyReachedLocation();
 
 	
 	bool IsTaskActive() const { return ActiveTask != nullptr; }
 	FName GetActiveTaskID() const;
+
+	// Current objective progress, for initial widget state before the first delta arrives
+	UFUNCTION(BlueprintPure, Category="T3D|Task")
+	int32 GetCurrentObjectiveIndex() const { return CurrentObjectiveIndex; }
+	UFUNCTION(BlueprintPure, Category="T3D|Task")
+	int32 GetCurrentObjectiveCount() const { return CurrentObjectiveCount; }
+	UFUNCTION(BlueprintPure, Category="T3D|Task")
+	int32 GetCurrentObjectiveTargetCount() const;
 	
+	// Grab on the game thread, then Read() from any thread for as long as the reference is held.
+	// Republished at most once per frame, only when progress changed.
+	TSharedRef<const FT3DTaskSnapshotBuffer, ESPMode::ThreadSafe> GetSnapshotBuffer() const { return SnapshotBuffer; }
+
+	// Heap owned by the subsystem, including the telemetry ring. Used by t3d.MemReport.
+	SIZE_T GetAllocatedBytes() const;
+
 	// Save/Load
 	void SaveTaskProgress();
 	void LoadTaskProgress();
 protected:
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject - only ticks while there are deltas to flush or a snapshot to publish
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override { return PendingDeltas.Num() > 0 || bSnapshotDirty; }
+	virtual bool IsTickableWhenPaused() const override { return true; }
+	virtual TStatId GetStatId() const override;
 
 private:
 	UPROPERTY()
@@ -47,8 +158,37 @@ private:
 	int32 CurrentObjectiveCount = 0;
 	
 	void AdvanceObjectiveIfComplete();
+	// Applies one unit of progress of the given type to the local task, if its objective matches
+	void ProgressLocalTask(ET3DTaskType Type);
+	// True when Player's progress is the local task rather than a per-player state
+	bool IsLocalTaskOwner(const AController* Player) const;
+	void ProgressTaskForPlayer(AController* Player, ET3DTaskType Type);
 	void CompleteTask();
 
+	// Folds a change into this frame's delta for the objective, or starts a new one
+	void QueueProgressDelta(ET3DTaskChange Change, FName TaskID, int32 ObjectiveIndex, int32 Count, int32 TargetCount);
+	void FlushProgressDeltas();
+
+	TArray<FT3DTaskProgressDelta> PendingDeltas;
+
+	TSharedRef<FT3DTaskSnapshotBuffer, ESPMode::ThreadSafe> SnapshotBuffer = MakeShared<FT3DTaskSnapshotBuffer, ESPMode::ThreadSafe>();
+	bool bSnapshotDirty = false;
+	void PublishSnapshot();
+
+	// Null when t3d.Telemetry.Enabled is off
+	TUniquePtr<FT3DTelemetrySink> Telemetry;
+	double ObjectiveStartSeconds = 0.0;
+	void RecordTelemetry(ET3DTelemetryEvent Event, int32 ObjectiveIndex, int32 Count) const;
+
+	UPROPERTY()
+	TArray<FT3DPlayerTaskState> PlayerTasks;
+
+	FT3DPlayerTaskState* FindPlayerTask(const AController* Player);
+	// Applies one unit of progress of the given type; returns false if the objective didn't match
+	static bool ProgressPlayerTask(FT3DPlayerTaskState& State, ET3DTaskType Type);
+	void OnPlayerLogout(AGameModeBase* GameMode, AController* Exiting);
+	FDelegateHandle LogoutHandle;
+
 	// helper to persist (slot name)
 	FString SaveSlotName = TEXT("PlayerSaveSlot");
 	uint32 UserIndex = 0;
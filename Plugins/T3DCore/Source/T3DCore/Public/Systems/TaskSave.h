@@ -15,6 +15,11 @@ class T3DCORE_API UTaskSave : public USaveGame
 	GENERATED_BODY()
 
 public:
+	UTaskSave();
+
+	// Save objects constructed since startup, excluding the CDO. Read by t3d.MemReport.
+	static uint32 GetNumCreated();
+
 	UPROPERTY()
 	FName SavedTaskID = NAME_None;
 
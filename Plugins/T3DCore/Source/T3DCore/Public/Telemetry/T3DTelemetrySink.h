@@ -0,0 +1,84 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/CircularQueue.h"
+#include "HAL/Runnable.h"
+#include "Data/T3DTaskData.h"
+
+class FRunnableThread;
+
+enum class ET3DTelemetryEvent : uint8
+{
+	TaskStarted,
+	ObjectiveProgress,
+	ObjectiveCompleted,
+	TaskCompleted,
+	TaskAbandoned
+};
+
+// Fixed-size so the ring never allocates on the game thread
+struct FT3DTelemetryRecord
+{
+	// Seconds since the sink was created
+	double SessionSeconds = 0.0;
+	FName TaskID;
+	int32 ObjectiveIndex = 0;
+	int32 Count = 0;
+	int32 TargetCount = 0;
+	// Time spent on the current objective when the record was taken
+	float ObjectiveSeconds = 0.f;
+	ET3DTelemetryEvent Event = ET3DTelemetryEvent::TaskStarted;
+	ET3DTaskType TaskType = ET3DTaskType::ReachLocation;
+};
+
+/**
+ * Local task progression telemetry.
+ *
+ * Record() pushes into a lock-free single-producer ring and returns; a background thread
+ * drains the ring into CSV files under Saved/Telemetry/, rotating when a file grows past
+ * t3d.Telemetry.MaxFileKB and keeping at most t3d.Telemetry.MaxFiles of them.
+ */
+class T3DCORE_API FT3DTelemetrySink : public FRunnable
+{
+public:
+	FT3DTelemetrySink();
+	virtual ~FT3DTelemetrySink() override;
+
+	// Game thread only. Drops the record if the writer has fallen a full ring behind.
+	void Record(ET3DTelemetryEvent Event, FName TaskID, ET3DTaskType TaskType, int32 ObjectiveIndex, int32 Count, int32 TargetCount, float ObjectiveSeconds);
+
+	double GetSessionSeconds() const { return FPlatformTime::Seconds() - SessionStartSeconds; }
+	uint32 GetDroppedCount() const { return DroppedCount.load(std::memory_order_relaxed); }
+	SIZE_T GetAllocatedSize() const;
+
+	static bool IsEnabled();
+
+private:
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+	void DrainRing();
+	void OpenNextFile();
+	void PruneOldFiles() const;
+
+	TCircularQueue<FT3DTelemetryRecord> Ring;
+	FRunnableThread* Thread = nullptr;
+	FEvent* WakeEvent = nullptr;
+	std::atomic<bool> bStopping{ false };
+	std::atomic<uint32> DroppedCount{ 0 };
+
+	double SessionStartSeconds = 0.0;
+
+	// Writer thread state
+	TUniquePtr<FArchive> Writer;
+	FString Directory;
+	FString SessionStamp;
+	int32 FilePart = 0;
+	bool bReportedOpenFailure = false;
+	FString LineBuffer;
+	// LineBuffer's allocation as last seen by the writer, for GetAllocatedSize on the game thread
+	std::atomic<SIZE_T> LineBufferBytes{ 0 };
+};
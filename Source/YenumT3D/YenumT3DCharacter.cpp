@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "YenumT3DCharacter.h"
+
+#include "EnhancedInputComponent.h"
+#include "EnhancedInputSubsystems.h"
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/PlayerController.h"
+#include "InputActionValue.h"
+#include "Performance/InputLatency.h"
+
+void AYenumT3DCharacter::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+
+	const APlayerController* PlayerController = Cast<APlayerController>(Controller);
+	UEnhancedInputLocalPlayerSubsystem* Subsystem = PlayerController
+		? ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()) : nullptr;
+	if (!Subsystem)
+	{
+		return;
+	}
+	for (const UInputMappingContext* Context : MappingContexts)
+	{
+		if (Context)
+		{
+			Subsystem->AddMappingContext(Context, 0);
+		}
+	}
+}
+
+void AYenumT3DCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
+{
+	Super::SetupPlayerInputComponent(PlayerInputComponent);
+
+	UEnhancedInputComponent* Input = Cast<UEnhancedInputComponent>(PlayerInputComponent);
+	if (!Input)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s needs an Enhanced Input component (Project Settings > Input > Default Input Component Class)"),
+			*GetNameSafe(this));
+		return;
+	}
+	if (JumpAction)
+	{
+		Input->BindAction(JumpAction, ETriggerEvent::Started, this, &AYenumT3DCharacter::StartJump);
+		Input->BindAction(JumpAction, ETriggerEvent::Completed, this, &ACharacter::StopJumping);
+	}
+	if (MoveAction)
+	{
+		Input->BindAction(MoveAction, ETriggerEvent::Triggered, this, &AYenumT3DCharacter::Move);
+	}
+	if (LookAction)
+	{
+		Input->BindAction(LookAction, ETriggerEvent::Triggered, this, &AYenumT3DCharacter::Look);
+	}
+	if (MouseLookAction)
+	{
+		Input->BindAction(MouseLookAction, ETriggerEvent::Triggered, this, &AYenumT3DCharacter::MouseLook);
+	}
+}
+
+void AYenumT3DCharacter::Move(const FInputActionValue& Value)
+{
+	const FVector2D Axis = Value.Get<FVector2D>();
+	if (Controller)
+	{
+		const FRotator YawRotation(0.0, Controller->GetControlRotation().Yaw, 0.0);
+		const FRotationMatrix Rotation(YawRotation);
+		AddMovementInput(Rotation.GetUnitAxis(EAxis::X), Axis.Y);
+		AddMovementInput(Rotation.GetUnitAxis(EAxis::Y), Axis.X);
+	}
+	SSP_INPUT_CONSUMED(MoveAction.Get());
+}
+
+void AYenumT3DCharacter::Look(const FInputActionValue& Value)
+{
+	const FVector2D Axis = Value.Get<FVector2D>();
+	AddControllerYawInput(Axis.X);
+	AddControllerPitchInput(Axis.Y);
+	SSP_INPUT_CONSUMED(LookAction.Get());
+}
+
+void AYenumT3DCharacter::MouseLook(const FInputActionValue& Value)
+{
+	const FVector2D Axis = Value.Get<FVector2D>();
+	AddControllerYawInput(Axis.X);
+	AddControllerPitchInput(Axis.Y);
+	SSP_INPUT_CONSUMED(MouseLookAction.Get());
+}
+
+void AYenumT3DCharacter::StartJump()
+{
+	Jump();
+	SSP_INPUT_CONSUMED(JumpAction.Get());
+}
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Character.h"
+#include "YenumT3DCharacter.generated.h"
+
+class UInputAction;
+class UInputMappingContext;
+struct FInputActionValue;
+
+/**
+ * Third person character with its input bound in C++, so every action it handles reports
+ * when it was consumed to the SSPCore input latency tracker. The probes themselves are bound
+ * per local player by UInputLatencySubsystem, whatever the pawn class.
+ */
+UCLASS(Abstract)
+class YENUMT3D_API AYenumT3DCharacter : public ACharacter
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void NotifyControllerChanged() override;
+	virtual void SetupPlayerInputComponent(UInputComponent* PlayerInputComponent) override;
+
+	// Added for the local player when possessed
+	UPROPERTY(EditAnywhere, Category="Input")
+	TArray<TObjectPtr<UInputMappingContext>> MappingContexts;
+
+	UPROPERTY(EditAnywhere, Category="Input")
+	TObjectPtr<UInputAction> JumpAction;
+
+	UPROPERTY(EditAnywhere, Category="Input")
+	TObjectPtr<UInputAction> MoveAction;
+
+	// Gamepad look
+	UPROPERTY(EditAnywhere, Category="Input")
+	TObjectPtr<UInputAction> LookAction;
+
+	UPROPERTY(EditAnywhere, Category="Input")
+	TObjectPtr<UInputAction> MouseLookAction;
+
+private:
+	void Move(const FInputActionValue& Value);
+	void Look(const FInputActionValue& Value);
+	void MouseLook(const FInputActionValue& Value);
+	void StartJump();
+};